@@ -0,0 +1,292 @@
+// Benchmarks of the graph library on synthetic graphs, reported as JSON on stdout.
+//
+// Usage: runBench [--vertices <n>] [--degree <d>] [--repeat <r>] [--seed <s>]
+//
+// The graph is a random DAG with n vertices and about n * d edges, so that every
+// benchmark, topoSort included, runs on the same graph. Each benchmark is run r times,
+// and its latencies, its throughput at the median latency, and the peak resident set
+// size of the process after it are reported.
+#include "../src/graph/adjacency_list.hpp"
+#include "../src/graph/concurrent_graph.hpp"
+#include "../src/graph/depth_first_search.hpp"
+#include "../src/graph/dynamic_dag.hpp"
+#include "../src/graph/io.hpp"
+#include "../src/graph/reachability.hpp"
+#include "../src/graph/topological_sort.hpp"
+#include "../src/graph/varint_graph.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sys/resource.h>
+
+using Graph = graph::AdjacencyList<graph::tags::Directed>;
+
+struct Config {
+    std::size_t vertices = 1 << 16;
+    std::size_t degree = 8;
+    std::size_t repeat = 5;
+    std::uint64_t seed = 1;
+};
+
+struct Result {
+    std::string name;
+    std::vector<double> latencyNs; // sorted
+    std::size_t edges;
+    long peakRssKiB;
+};
+
+// A DFS visitor counting the examined edges
+struct EdgeCountingVisitor : graph::DFSNullVisitor {
+    std::uint64_t *count;
+    EdgeCountingVisitor(std::uint64_t *count) : count(count) {}
+
+    template <typename G, typename E>
+    void examineEdge(const E &, const G &) { ++*count; }
+};
+
+// The peak resident set size of the process so far, in KiB.
+long peakRssKiB() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// The nearest-rank percentile p of the sorted samples.
+double percentile(const std::vector<double> &sorted, double p) {
+    const std::size_t rank = static_cast<std::size_t>(p / 100 * sorted.size() + 0.999999);
+    return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+// Random edges u -> v with u < v, without duplicates.
+std::vector<std::pair<std::size_t, std::size_t>> randomDag(const Config &config) {
+    std::uint64_t x = config.seed;
+    auto next = [&] {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        return x >> 33;
+    };
+    const std::size_t n = config.vertices;
+    std::vector<std::pair<std::size_t, std::size_t>> el;
+    if (n < 2)
+        return el;
+    el.reserve(n * config.degree);
+    for (std::size_t k = 0; k < n * config.degree; ++k)
+    {
+        std::size_t u = next() % n, v = next() % n;
+        if (u == v)
+            continue;
+        if (u > v)
+            std::swap(u, v);
+        el.emplace_back(u, v);
+    }
+    std::sort(el.begin(), el.end());
+    el.erase(std::unique(el.begin(), el.end()), el.end());
+    // in a random order, as addEdge would see them from a file
+    for (std::size_t k = el.size(); k > 1; --k)
+        std::swap(el[k - 1], el[next() % k]);
+    return el;
+}
+
+std::string toDimacs(std::size_t n, const std::vector<std::pair<std::size_t, std::size_t>> &el) {
+    std::ostringstream s;
+    s << "p edge " << n << ' ' << el.size() << '\n';
+    for (const auto &[u, v] : el)
+        s << "e " << u + 1 << ' ' << v + 1 << '\n';
+    return s.str();
+}
+
+// Runs f config.repeat times. f returns a checksum of its work, which is kept so the
+// work cannot be optimised away.
+Result run(const std::string &name, std::size_t edges, const Config &config, std::uint64_t &checksum,
+           const std::function<std::uint64_t()> &f) {
+    Result r{name, {}, edges, 0};
+    for (std::size_t i = 0; i < config.repeat; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        checksum += f();
+        const auto stop = std::chrono::steady_clock::now();
+        r.latencyNs.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+    }
+    std::sort(r.latencyNs.begin(), r.latencyNs.end());
+    r.peakRssKiB = peakRssKiB();
+    return r;
+}
+
+void printJson(std::ostream &s, const Config &config, std::size_t edges, const std::vector<Result> &results,
+               std::uint64_t checksum) {
+    s << std::setprecision(10) << "{\n";
+    s << "  \"config\": {\"vertices\": " << config.vertices << ", \"degree\": " << config.degree
+      << ", \"edges\": " << edges << ", \"repeat\": " << config.repeat << ", \"seed\": " << config.seed << "},\n";
+    s << "  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const Result &r = results[i];
+        double mean = 0;
+        for (double t : r.latencyNs)
+            mean += t / r.latencyNs.size();
+        const double median = percentile(r.latencyNs, 50);
+        s << "    {\"name\": \"" << r.name << "\", \"edges\": " << r.edges
+          << ", \"edgesPerSecond\": " << (median > 0 ? r.edges / (median * 1e-9) : 0.0)
+          << ", \"latencyNs\": {\"min\": " << r.latencyNs.front() << ", \"p50\": " << median
+          << ", \"p90\": " << percentile(r.latencyNs, 90) << ", \"p99\": " << percentile(r.latencyNs, 99)
+          << ", \"max\": " << r.latencyNs.back() << ", \"mean\": " << mean << "}"
+          << ", \"peakRssKiB\": " << r.peakRssKiB << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    s << "  ],\n";
+    s << "  \"peakRssKiB\": " << peakRssKiB() << ",\n";
+    s << "  \"checksum\": " << checksum << "\n";
+    s << "}\n";
+}
+
+Config parseArgs(int argc, char **argv) {
+    Config config;
+    for (int i = 1; i < argc; ++i)
+    {
+        auto value = [&]() -> std::uint64_t {
+            if (i + 1 == argc)
+                throw std::runtime_error(std::string("Expected a value after ") + argv[i] + ".");
+            char *end;
+            const std::uint64_t v = std::strtoull(argv[++i], &end, 10);
+            if (*argv[i] == '\0' || *end != '\0')
+                throw std::runtime_error(std::string("Expected a number, got '") + argv[i] + "'.");
+            return v;
+        };
+        if (std::strcmp(argv[i], "--vertices") == 0)
+            config.vertices = value();
+        else if (std::strcmp(argv[i], "--degree") == 0)
+            config.degree = value();
+        else if (std::strcmp(argv[i], "--repeat") == 0)
+            config.repeat = value();
+        else if (std::strcmp(argv[i], "--seed") == 0)
+            config.seed = value();
+        else
+            throw std::runtime_error(std::string("Unknown option '") + argv[i] + "'.");
+    }
+    if (config.repeat == 0)
+        throw std::runtime_error("Expected at least one repetition.");
+    return config;
+}
+
+int main(int argc, char **argv) {
+    Config config;
+    try
+    {
+        config = parseArgs(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << "\nUsage: " << argv[0]
+                  << " [--vertices <n>] [--degree <d>] [--repeat <r>] [--seed <s>]\n";
+        return 1;
+    }
+
+    const std::size_t n = config.vertices;
+    const auto el = randomDag(config);
+    const std::size_t m = el.size();
+    const std::string dimacs = toDimacs(n, el);
+    const Graph g(n, el.begin(), el.end());
+    std::uint64_t checksum = 0;
+    std::vector<Result> results;
+
+    results.push_back(run("loadDimacs/stream", m, config, checksum, [&] {
+        std::istringstream s(dimacs);
+        return numEdges(graph::loadDimacs<Graph>(s));
+    }));
+    results.push_back(run("loadDimacs/buffer", m, config, checksum, [&] {
+        return numEdges(graph::loadDimacs<Graph>(dimacs.data(), dimacs.data() + dimacs.size()));
+    }));
+    results.push_back(run("addEdge", m, config, checksum, [&] {
+        Graph h(n);
+        for (const auto &[u, v] : el)
+            addEdge(u, v, h);
+        return numEdges(h);
+    }));
+    results.push_back(run("addEdge/arena", m, config, checksum, [&] {
+        graph::ArenaAdjacencyList<graph::tags::Directed> h(n);
+        for (const auto &[u, v] : el)
+            addEdge(u, v, h);
+        return numEdges(h);
+    }));
+    results.push_back(run("addEdge/concurrent", m, config, checksum, [&] {
+        graph::ConcurrentGraph<graph::tags::Directed> h(n);
+        graph::parallelFor(0, m, [&](std::size_t k) { addEdge(el[k].first, el[k].second, h); });
+        return numEdges(h.freeze());
+    }));
+    results.push_back(run("dfs", m, config, checksum, [&] {
+        std::uint64_t count = 0;
+        graph::dfs(g, EdgeCountingVisitor(&count), graph::tags::DFSIterative());
+        return count;
+    }));
+    results.push_back(run("topoSort", m, config, checksum, [&] {
+        std::vector<Graph::VertexDescriptor> order;
+        order.reserve(n);
+        graph::topoSort(g, std::back_inserter(order));
+        return order.empty() ? 0 : std::uint64_t(order.front());
+    }));
+    // against the initial order by index, so insertions have to reorder
+    results.push_back(run("dynamicDag/addEdge", m, config, checksum, [&] {
+        graph::DynamicDAG<> d(n);
+        for (const auto &[u, v] : el)
+            addEdge(n - 1 - u, n - 1 - v, d);
+        return std::uint64_t(d.position(0));
+    }));
+    // the closure when it fits the default budget, the labels otherwise
+    results.push_back(run("reachability/build", m, config, checksum, [&] {
+        return std::uint64_t(graph::ReachabilityIndex(g).memoryBytes());
+    }));
+    const graph::ReachabilityIndex reachability(g);
+    results.push_back(run("reachability/query", m, config, checksum, [&] {
+        std::uint64_t count = 0, x = config.seed;
+        for (std::size_t k = 0; k < m; ++k) {
+            x = x * 6364136223846793005ull + 1442695040888963407ull;
+            count += reachability.reachable((x >> 33) % n, (x >> 13) % n);
+        }
+        return count;
+    }));
+    results.push_back(run("edges", m, config, checksum, [&] {
+        std::uint64_t sum = 0;
+        for (auto e : edges(g))
+            sum += target(e, g);
+        return sum;
+    }));
+    results.push_back(run("outEdges", m, config, checksum, [&] {
+        std::uint64_t sum = 0;
+        for (auto u : vertices(g))
+            for (auto e : outEdges(u, g))
+                sum += target(e, g);
+        return sum;
+    }));
+    const graph::VarintGraph<graph::tags::Directed> varint(g);
+    results.push_back(run("outEdges/varint", m, config, checksum, [&] {
+        std::uint64_t sum = 0;
+        for (auto u : vertices(varint))
+            for (auto e : outEdges(u, varint))
+                sum += target(e, varint);
+        return sum;
+    }));
+    const graph::VarintGraph<graph::tags::Directed, graph::tags::GroupVarint> groupVarint(g);
+    results.push_back(run("outEdges/groupVarint", m, config, checksum, [&] {
+        std::uint64_t sum = 0;
+        for (auto u : vertices(groupVarint))
+            for (auto e : outEdges(u, groupVarint))
+                sum += target(e, groupVarint);
+        return sum;
+    }));
+    results.push_back(run("printDot", m, config, checksum, [&] {
+        std::ostringstream s;
+        graph::printDot(s, g);
+        return std::uint64_t(s.tellp());
+    }));
+
+    printJson(std::cout, config, m, results, checksum);
+    return 0;
+}
@@ -1,6 +1,9 @@
 #ifndef GRAPH_ADJACENCY_LIST_HPP
 #define GRAPH_ADJACENCY_LIST_HPP
 
+#include "edge_index.hpp"
+#include "edge_lists.hpp"
+#include "parallel.hpp"
 #include "properties.hpp"
 #include "tags.hpp"
 #include "traits.hpp"
@@ -9,23 +12,48 @@
 #include <boost/iterator/filter_iterator.hpp>
 #include <boost/iterator/iterator_adaptor.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <list>
+#include <optional>
+#include <utility>
 #include <vector>
 
 namespace graph
 {
 
+  /// @brief  A graph stored as per-vertex lists of incident edges plus a list of all edges
+  /// @tparam EdgeIndexT The edge index policy, NoEdgeIndex or HashEdgeIndex<> (see edge_index.hpp),
+  ///         which stores its keys and indices as IndexT
+  /// @tparam IndexT The unsigned integer type of vertex and edge indices in descriptors and
+  ///         stored edges. A narrower type, e.g., std::uint32_t, makes every stored edge smaller,
+  ///         but limits the number of vertices and edges to its maximum value.
+  /// @tparam EdgeListsT The edge list policy, VectorEdgeLists or ArenaEdgeLists (see edge_lists.hpp)
   template <typename DirectedCategoryT,
-            typename VertexPropT = NoProp, typename EdgePropT = NoProp>
+            typename VertexPropT = NoProp, typename EdgePropT = NoProp,
+            typename EdgeIndexT = NoEdgeIndex, typename IndexT = std::size_t,
+            typename EdgeListsT = VectorEdgeLists>
   struct AdjacencyList
   {
+    static_assert(std::is_unsigned_v<IndexT>, "The index type must be an unsigned integer type.");
+
   public: // PropertyGraph
     /// @brief  Vertex property type
     using VertexProp = VertexPropT;
     /// @brief  Edge property type
     using EdgeProp = EdgePropT;
 
+  public:
+    /// @brief  Edge index policy, rebound to IndexT
+    using EdgeIndex = typename EdgeIndexT::template Rebind<IndexT>;
+
+  private:
+    /// @brief  Whether an edge index is maintained next to the edge list
+    static constexpr bool hasEdgeIndex = !std::is_same_v<EdgeIndexT, NoEdgeIndex>;
+
   private:
     /// @brief  Represents an out edge of a vertex
     struct OutEdge
@@ -35,12 +63,12 @@ namespace graph
       /// @brief Sets the target vertex and the index of the edge in the edge list
       /// @param tar
       /// @param storedEdgeIdx
-      OutEdge(std::size_t tar, std::size_t storedEdgeIdx)
+      OutEdge(IndexT tar, IndexT storedEdgeIdx)
           : tar(tar), storedEdgeIdx(storedEdgeIdx) {}
 
     public:
-      std::size_t tar;           // target vertex
-      std::size_t storedEdgeIdx; // index of the edge in the edge list
+      IndexT tar;           // target vertex
+      IndexT storedEdgeIdx; // index of the edge in the edge list
     };
 
     /// @brief  Represents an in edge of a vertex
@@ -51,18 +79,18 @@ namespace graph
       /// @brief Sets the source vertex and the index of the edge in the edge list
       /// @param src
       /// @param storedEdgeIdx
-      InEdge(std::size_t src, std::size_t storedEdgeIdx)
+      InEdge(IndexT src, IndexT storedEdgeIdx)
           : src(src), storedEdgeIdx(storedEdgeIdx) {}
 
     public:
-      std::size_t src;           // source vertex
-      std::size_t storedEdgeIdx; // index of the edge in the edge list
+      IndexT src;           // source vertex
+      IndexT storedEdgeIdx; // index of the edge in the edge list
     };
 
     /// @brief  Represents a list of out edges of a vertex
-    using OutEdgeList = std::vector<OutEdge>;
+    using OutEdgeList = typename EdgeListsT::template List<OutEdge>;
     /// @brief  Represents a list of in edges of a vertex
-    using InEdgeList = std::vector<InEdge>;
+    using InEdgeList = typename EdgeListsT::template List<InEdge>;
 
     /// @brief A directed or undirected vertex
     /// If undirected, we just don't use the out edge list
@@ -72,18 +100,12 @@ namespace graph
       VertexProp vp;
 
     public:
-      /// @brief  Default constructor
-      StoredVertexDirected() : eOut(new OutEdgeList)
-      {
-        // If the vertex property is not NoProp, we initialize it
-        if constexpr (!std::is_same_v<NoProp, VertexProp>)
-        {
-          vp = VertexPropT();
-        }
-      }
+      /// @brief  Default constructor, the vertex property is value-initialized
+      StoredVertexDirected() : eOut(), vp() {}
 
       /// @brief  Constructor, vertex property is set by the user
-      StoredVertexDirected(OutEdgeList eOut, VertexProp &vp) : eOut(eOut), vp(vp) {}
+      StoredVertexDirected(OutEdgeList eOut, VertexProp vp = VertexProp())
+          : eOut(std::move(eOut)), vp(std::move(vp)) {}
     };
 
     /// @brief A bidirectional vertex
@@ -94,17 +116,11 @@ namespace graph
       VertexProp vp;
 
     public:
-      /// @brief  Default constructor
-      StoredVertexBidirectional() : eOut(new OutEdgeList), eIn(new InEdgeList)
-      {
-        // If the vertex property is not NoProp, we initialize it
-        if constexpr (!std::is_same_v<NoProp, VertexProp>)
-        {
-          vp = VertexPropT();
-        }
-      }
+      /// @brief  Default constructor, the vertex property is value-initialized
+      StoredVertexBidirectional() : eOut(), eIn(), vp() {}
       /// @brief  Constructor, vertex property is set by the user
-      StoredVertexBidirectional(OutEdgeList eOut, InEdgeList eIn, VertexProp &vp) : eOut(eOut), eIn(eIn), vp(vp) {}
+      StoredVertexBidirectional(OutEdgeList eOut, InEdgeList eIn, VertexProp vp = VertexProp())
+          : eOut(std::move(eOut)), eIn(std::move(eIn)), vp(std::move(vp)) {}
     };
 
     // If the graph is directed, we use StoredVertexDirected, otherwise we use StoredVertexBidirectional. We do this
@@ -117,20 +133,14 @@ namespace graph
     /// @brief  Represents an edge
     struct StoredEdge
     {
-      std::size_t src, tar;
+      IndexT src, tar;
       EdgeProp ep;
 
-      /// @brief  Default constructor
-      StoredEdge() : src(0), tar(0)
-      {
-        // If the edge property is not NoProp, we initialize it
-        if constexpr (!std::is_same_v<NoProp, EdgeProp>)
-        {
-          ep = new EdgePropT();
-        }
-      }
+      /// @brief  Default constructor, the edge property is value-initialized
+      StoredEdge() : src(0), tar(0), ep() {}
       /// @brief  Constructor, edge property is set by the user
-      StoredEdge(std::size_t src, std::size_t tar, EdgeProp ep) : src(src), tar(tar), ep(&ep) {}
+      StoredEdge(IndexT src, IndexT tar, EdgeProp ep = EdgeProp())
+          : src(src), tar(tar), ep(std::move(ep)) {}
     };
 
     /// @brief Represents a list of vertices
@@ -142,7 +152,7 @@ namespace graph
     /// @brief  Directed category
     using DirectedCategory = DirectedCategoryT;
     /// @brief  Vertex descriptor
-    using VertexDescriptor = std::size_t;
+    using VertexDescriptor = IndexT;
 
     /// @brief  Edge descriptor
     /// @details  The edge descriptor is a struct that contains the source and target vertices of the edge, as well as
@@ -152,12 +162,12 @@ namespace graph
       /// @brief  Default constructor
       EdgeDescriptor() = default;
       /// @brief  Constructor, sets the source and target vertices and the index of the edge in the edge list
-      EdgeDescriptor(std::size_t src, std::size_t tar, std::size_t storedEdgeIdx)
+      EdgeDescriptor(IndexT src, IndexT tar, IndexT storedEdgeIdx)
           : src(src), tar(tar), storedEdgeIdx(storedEdgeIdx) {}
 
     public:
-      std::size_t src, tar;
-      std::size_t storedEdgeIdx;
+      IndexT src, tar;
+      IndexT storedEdgeIdx;
 
     public:
       /// @brief  Equality operator
@@ -200,7 +210,7 @@ namespace graph
 
         /// @brief Returns the end of the range
         /// @return An iterator to the end of the range
-        iterator end() const { return iterator(n); }
+        iterator end() const { return iterator(static_cast<VertexDescriptor>(n)); }
 
     private:
       std::size_t n;
@@ -252,7 +262,7 @@ namespace graph
           // boost::iterator_adaptor base class
           const EListIterator &i = this->base_reference();
           return EdgeDescriptor{i->src, i->tar,
-                                static_cast<std::size_t>(i - first)};
+                                static_cast<IndexT>(i - first)};
         }
 
       private:
@@ -300,8 +310,8 @@ namespace graph
       public:
         /// @brief  Default constructor
         iterator() = default;
-        /// @brief  Constructor, sets the iterator we adapt and the first iterator in the range
-        iterator(OutEdgeListIterator i, OutEdgeListIterator first) : Base(i), first(first) {}
+        /// @brief  Constructor, sets the iterator we adapt and the source vertex of the range
+        iterator(OutEdgeListIterator i, VertexDescriptor v) : Base(i), v(v) {}
 
       private:
         friend class boost::iterator_core_access;
@@ -315,25 +325,25 @@ namespace graph
         }
 
       private:
-        OutEdgeListIterator first;
+        VertexDescriptor v;
       };
 
     public:
       /// @brief  Constructor, sets the vertex and the graph
       /// @param v Vertex
       /// @param g Graph
-      OutEdgeRange(VertexDescriptor v, const AdjacencyList &g) : v(v), g(&g) {}
+      OutEdgeRange(VertexDescriptor v, const AdjacencyList &g) : g(&g), v(v) {}
 
       /// @brief  Returns the beginning of the range
       iterator begin() const
       {
-        return iterator(g->vList[v].eOut.begin(), g->vList[v].eOut.begin());
+        return iterator(g->vList[v].eOut.begin(), v);
       }
 
       /// @brief  Returns the end of the range
       iterator end() const
       {
-        return iterator(g->vList[v].eOut.end(), g->vList[v].eOut.begin());
+        return iterator(g->vList[v].eOut.end(), v);
       }
 
     private:
@@ -365,8 +375,8 @@ namespace graph
       public:
         /// @brief  Default constructor
         iterator() = default;
-        /// @brief  Constructor, sets the iterator we adapt and the first iterator in the range
-        iterator(InEdgeListIterator i, InEdgeListIterator first) : Base(i), first(first) {}
+        /// @brief  Constructor, sets the iterator we adapt and the target vertex of the range
+        iterator(InEdgeListIterator i, VertexDescriptor v) : Base(i), v(v) {}
 
       private:
         friend class boost::iterator_core_access;
@@ -376,29 +386,29 @@ namespace graph
         EdgeDescriptor dereference() const
         {
           const InEdgeListIterator &i = this->base_reference();
-          return EdgeDescriptor{i->src, i->tar, static_cast<std::size_t>(i - first)};
+          return EdgeDescriptor{i->src, v, i->storedEdgeIdx};
         }
 
       private:
-        InEdgeListIterator first;
+        VertexDescriptor v;
       };
 
     public:
       /// @brief  Constructor, sets the vertex and the graph
       /// @param v Vertex
       /// @param g Graph
-      InEdgeRange(VertexDescriptor v, const AdjacencyList &g) : v(v), g(&g) {}
+      InEdgeRange(VertexDescriptor v, const AdjacencyList &g) : g(&g), v(v) {}
 
       /// @brief  Returns the beginning of the range
       iterator begin() const
       {
-        return iterator(g->vList[v].eIn.begin(), g->vList[v].eIn.begin());
+        return iterator(g->vList[v].eIn.begin(), v);
       }
 
       /// @brief  Returns the end of the range
       iterator end() const
       {
-        return iterator(g->vList[v].eIn.end(), g->vList[v].eIn.begin());
+        return iterator(g->vList[v].eIn.end(), v);
       }
 
     private:
@@ -411,17 +421,82 @@ namespace graph
     AdjacencyList() = default;
     /// @brief Constructor, sets the number of vertices
     /// @param n
-    AdjacencyList(std::size_t n) : vList(n) {}
+    AdjacencyList(std::size_t n) : vList(n)
+    {
+      assert(n <= std::numeric_limits<IndexT>::max());
+    }
+    /// @brief Constructor, sets the number of vertices and adds the edges in [first, last) in bulk
+    /// @details See addEdges
+    /// @param n The number of vertices
+    /// @param first The first edge, destructurable into a source and a target, e.g., a std::pair
+    /// @param last One past the last edge
+    /// @param pool The thread pool the lists are filled on
+    template <std::forward_iterator EdgeIter>
+    AdjacencyList(std::size_t n, EdgeIter first, EdgeIter last, ThreadPool &pool = defaultThreadPool()) : vList(n)
+    {
+      assert(n <= std::numeric_limits<IndexT>::max());
+      addEdges(first, last, *this, pool);
+    }
+
+    /// @brief Copy constructor, the edge lists are copied through the edge list policy
+    AdjacencyList(const AdjacencyList &other)
+        : lists(other.lists), eList(other.eList), eIndex(other.eIndex)
+    {
+      vList.reserve(other.vList.size());
+      for (const StoredVertex &sv : other.vList)
+      {
+        if constexpr (std::is_same_v<DirectedCategory, tags::Bidirectional>)
+        {
+          vList.emplace_back(lists.copy(sv.eOut), lists.copy(sv.eIn), sv.vp);
+        }
+        else
+        {
+          vList.emplace_back(lists.copy(sv.eOut), sv.vp);
+        }
+      }
+    }
+
+    /// @brief Move constructor
+    AdjacencyList(AdjacencyList &&) = default;
+
+    /// @brief Copy assignment operator
+    AdjacencyList &operator=(const AdjacencyList &other)
+    {
+      if (this != &other)
+      {
+        *this = AdjacencyList(other);
+      }
+      return *this;
+    }
+
+    /// @brief Move assignment operator
+    AdjacencyList &operator=(AdjacencyList &&) = default;
 
   private:
+    [[no_unique_address]] EdgeListsT lists;
     VList vList;
     EList eList;
+    [[no_unique_address]] EdgeIndex eIndex;
+
+    /// @brief  The key of the edge (u, v) in the edge index
+    /// @details Undirected edges are keyed on their ordered end-points, so (v, u) finds (u, v)
+    static std::pair<std::size_t, std::size_t> edgeKey(VertexDescriptor u, VertexDescriptor v)
+    {
+      if constexpr (std::is_same_v<DirectedCategoryT, tags::Undirected>)
+      {
+        if (v < u)
+        {
+          return {v, u};
+        }
+      }
+      return {u, v};
+    }
 
   public: // Graph
     /// @brief  Returns the source vertex of an edge
     /// @param e The edge
     /// @param g The graph
-    friend VertexDescriptor source(EdgeDescriptor e, const AdjacencyList &g)
+    friend VertexDescriptor source(EdgeDescriptor e, const AdjacencyList &)
     {
       return e.src;
     }
@@ -429,7 +504,7 @@ namespace graph
     /// @brief Returns the target vertex of an edge
     /// @param e The edge
     /// @param g The graph
-    friend VertexDescriptor target(EdgeDescriptor e, const AdjacencyList &g)
+    friend VertexDescriptor target(EdgeDescriptor e, const AdjacencyList &)
     {
       return e.tar;
     }
@@ -457,8 +532,36 @@ namespace graph
     friend EdgeRange edges(const AdjacencyList &g) { return EdgeRange(g); }
 
   public: // Other
+    /// @brief Looks up the edge from u to v
+    /// @details O(1) expected with HashEdgeIndex, otherwise O(outDegree(u)).
+    /// For undirected graphs the edge may have been added as (v, u).
+    /// @return The edge, or std::nullopt if there is no such edge
+    friend std::optional<EdgeDescriptor> edge(VertexDescriptor u, VertexDescriptor v,
+                                              const AdjacencyList &g)
+    {
+      if constexpr (hasEdgeIndex)
+      {
+        const auto [src, tar] = edgeKey(u, v);
+        if (const auto idx = g.eIndex.find(src, tar))
+        {
+          return EdgeDescriptor(u, v, *idx);
+        }
+      }
+      else
+      {
+        for (const auto &oe : g.vList[u].eOut)
+        {
+          if (oe.tar == v)
+          {
+            return EdgeDescriptor(u, v, oe.storedEdgeIdx);
+          }
+        }
+      }
+      return std::nullopt;
+    }
+
     /// @brief Returns the index of a vertex
-    friend std::size_t getIndex(VertexDescriptor v, const AdjacencyList &g)
+    friend std::size_t getIndex(VertexDescriptor v, const AdjacencyList &)
     {
       return v;
     }
@@ -474,54 +577,45 @@ namespace graph
     }
 
     /// @brief Returns the number of out edges of a vertex
+    /// @details O(1), the size of the out-edge list of v. For undirected graphs
+    /// every incident edge is stored in this list.
     friend std::size_t outDegree(const VertexDescriptor v,
                                  const AdjacencyList &g)
     {
-      // If the graph is undirected, we can just return the number of out edges
-      if constexpr (std::is_same_v<DirectedCategory, tags::Undirected>) // constexpr, because is_same is compile time
-      {
-        // Return the number of out-edges of v in g
-        return g.vList[v].eOut.size();
-      }
-      else // otherwise, we need to count the number of edges that have v as a source or target
-      {
-        // Return the number of incident edges of v in g
-        std::size_t count = 0;
-        for (auto e : g.eList)
-        {
-          if (e.src == v || e.tar == v)
-          {
-            count++;
-          }
-        }
-        return count;
-      }
+      return g.vList[v].eOut.size();
     }
 
   public: // BidirectionalGraph
     /// @brief Returns a range of in edges
+    /// @details Only bidirectional graphs store their in-edges.
     friend InEdgeRange inEdges(const VertexDescriptor v,
                                const AdjacencyList &g)
+      requires std::is_same_v<DirectedCategory, tags::Bidirectional>
     {
       // return a range of the in-edges of v in g
       return InEdgeRange(v, g);
     }
 
     /// @brief Returns the number of in edges of a vertex
+    /// @details O(1) for undirected and bidirectional graphs. Directed graphs do not
+    /// store in-edges, so the edge list is scanned in O(m).
     friend std::size_t inDegree(const VertexDescriptor v, const AdjacencyList &g)
     {
-      // If the graph is undirected, we can just return the number of in edges
       if constexpr (std::is_same_v<DirectedCategory, tags::Undirected>)
       {
-        // return the number of in-edges of v in g
+        // The in-edges of an undirected vertex are its out-edges
+        return g.vList[v].eOut.size();
+      }
+      else if constexpr (std::is_same_v<DirectedCategory, tags::Bidirectional>)
+      {
         return g.vList[v].eIn.size();
       }
-      else // otherwise, we need to count the number of edges that have v as a source or target
+      else // otherwise, we need to count the number of edges that have v as a target
       {
         std::size_t count = 0;
-        for (auto e : g.eList)
+        for (const auto &e : g.eList)
         {
-          if (e.src == v || e.tar == v)
+          if (e.tar == v)
           {
             count++;
           }
@@ -537,17 +631,17 @@ namespace graph
     /// @return A descriptor for the newly added vertex
     friend VertexDescriptor addVertex(AdjacencyList &g)
     {
-      OutEdgeList out;
-      InEdgeList in;
+      // The index of the new vertex must be representable by IndexT
+      assert(g.vList.size() < std::numeric_limits<IndexT>::max());
 
       // Add a vertex and return a descriptor representing the newly added vertex
       if constexpr (std::is_same_v<DirectedCategory, tags::Bidirectional>)
       {
-        g.vList.emplace_back(out, in);
+        g.vList.emplace_back(OutEdgeList(), InEdgeList());
       }
       else
       {
-        g.vList.emplace_back(out);
+        g.vList.emplace_back(OutEdgeList());
       }
 
       return g.vList.size() - 1; // We set a unique id to be equal to the size of the list of
@@ -563,35 +657,172 @@ namespace graph
     friend EdgeDescriptor addEdge(VertexDescriptor u, VertexDescriptor v,
                                   AdjacencyList &g)
     {
-      // Both u and v are valid vertex descriptors for g
-      assert(u <= g.vList.size() && v <= g.vList.size());
-
-      // u and v are different
-      assert(u != v);
+      // The edge gets a value-initialized property
+      return addEdge(u, v, EdgeProp(), g);
+    }
 
-      // No edge (u, v) exist already in g
-      for (const auto &it : g.eList)
-      { // use iterator to iterate through each edge
-        assert(it.src != u && it.tar != v);
+    /// @brief Reserves capacity for m edges in total, e.g., before adding a known number of edges
+    /// @param m The number of edges
+    /// @param g The graph
+    friend void reserveEdges(std::size_t m, AdjacencyList &g)
+    {
+      g.eList.reserve(m);
+      if constexpr (hasEdgeIndex)
+      {
+        g.eIndex.reserve(m);
       }
+    }
 
-      // Add the edge to eList
-      g.eList.emplace_back(u, v);
-
-      EdgeDescriptor edge = EdgeDescriptor(u, v, g.eList.size() - 1);
+    /// @brief Adds the edges in [first, last) to the graph in bulk
+    /// @details The result is the same as calling addEdge for each edge in order, but
+    /// instead of growing every list one edge at a time, the edges are counted per vertex
+    /// in a first pass, then each list is grown once to its exact size and filled in a
+    /// second pass, with the vertices and the edge list split over threads for large batches.
+    /// With an edge index, duplicates of existing or earlier edges are skipped.
+    /// @param first The first edge, destructurable into a source and a target, e.g., a std::pair
+    /// @param last One past the last edge
+    /// @param g The graph to which the edges are added
+    /// @param pool The thread pool the lists are filled on
+    template <std::forward_iterator EdgeIter>
+    friend void addEdges(EdgeIter first, EdgeIter last, AdjacencyList &g, ThreadPool &pool = defaultThreadPool())
+    {
+      const std::size_t n = g.vList.size();
+      const std::size_t base = g.eList.size();
 
-      g.vList[u].eOut.emplace_back(edge);
+      // The edges to add, the index of each is base + its position
+      std::vector<std::pair<std::size_t, std::size_t>> batch;
+      batch.reserve(std::distance(first, last));
+      if constexpr (hasEdgeIndex)
+      {
+        g.eIndex.reserve(base + batch.capacity());
+      }
+      for (EdgeIter it = first; it != last; ++it)
+      {
+        const auto &[src, tar] = *it;
+        const std::size_t u = src, v = tar;
+        // Both u and v are valid vertex descriptors for g, and they are different
+        assert(u < n && v < n);
+        assert(u != v);
+        if constexpr (hasEdgeIndex)
+        {
+          const auto [key1, key2] = edgeKey(u, v);
+          if (!g.eIndex.insert(key1, key2, base + batch.size()).second)
+          {
+            continue;
+          }
+        }
+        batch.emplace_back(u, v);
+      }
+      // The indices of the new edges must be representable by IndexT
+      assert(base + batch.size() <= std::numeric_limits<IndexT>::max());
+#ifndef NDEBUG
+      if constexpr (!hasEdgeIndex)
+      {
+        // No edge (u, v) exist already in g, or earlier in the batch
+        std::vector<std::pair<std::size_t, std::size_t>> sorted = batch;
+        std::sort(sorted.begin(), sorted.end());
+        assert(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+        for (const auto &[u, v] : batch)
+        {
+          for (const auto &oe : g.vList[u].eOut)
+          {
+            assert(oe.tar != v);
+          }
+        }
+      }
+#endif
 
-      if constexpr (std::is_same_v<DirectedCategory, tags::Undirected>)
+      // First pass: count the new entries of each list, and sort the batch into them
+      constexpr bool isUndirected = std::is_same_v<DirectedCategory, tags::Undirected>;
+      constexpr bool isBidirectional = std::is_same_v<DirectedCategory, tags::Bidirectional>;
+      std::vector<std::size_t> outStart(n + 1, 0), inStart(isBidirectional ? n + 1 : 0, 0);
+      for (const auto &[u, v] : batch)
       {
-        g.vList[v].eOut.emplace_back(edge);
+        ++outStart[u + 1];
+        if constexpr (isUndirected)
+        {
+          ++outStart[v + 1];
+        }
+        if constexpr (isBidirectional)
+        {
+          ++inStart[v + 1];
+        }
       }
-      if constexpr (std::is_same_v<DirectedCategory, tags::Bidirectional>)
+      for (std::size_t v = 0; v < n; ++v)
       {
-        g.vList[v].eIn.emplace_back(edge);
+        outStart[v + 1] += outStart[v];
+        if constexpr (isBidirectional)
+        {
+          inStart[v + 1] += inStart[v];
+        }
+      }
+      // outOrder[outStart[v]...] are the positions in batch of the new entries of v, in order
+      std::vector<std::size_t> outOrder(outStart[n]), inOrder(isBidirectional ? inStart[n] : 0);
+      {
+        std::vector<std::size_t> outNext(outStart.begin(), outStart.end() - 1);
+        std::vector<std::size_t> inNext(inStart.begin(), inStart.empty() ? inStart.end() : inStart.end() - 1);
+        for (std::size_t i = 0; i < batch.size(); ++i)
+        {
+          const auto [u, v] = batch[i];
+          outOrder[outNext[u]++] = i;
+          if constexpr (isUndirected)
+          {
+            outOrder[outNext[v]++] = i;
+          }
+          if constexpr (isBidirectional)
+          {
+            inOrder[inNext[v]++] = i;
+          }
+        }
       }
 
-      return edge;
+      // Second pass: grow each list once and fill it, and fill the edge list
+      auto grow = [&](std::size_t v)
+      {
+        OutEdgeList &out = g.vList[v].eOut;
+        g.lists.reserve(out, out.size() + outStart[v + 1] - outStart[v]);
+        if constexpr (isBidirectional)
+        {
+          InEdgeList &in = g.vList[v].eIn;
+          g.lists.reserve(in, in.size() + inStart[v + 1] - inStart[v]);
+        }
+      };
+      if constexpr (!EdgeListsT::concurrentGrowth)
+      {
+        // The lists are grown here, so the parallel loop only fills them
+        for (std::size_t v = 0; v < n; ++v)
+        {
+          grow(v);
+        }
+      }
+      parallelFor(0, n, [&](std::size_t v)
+      {
+        if constexpr (EdgeListsT::concurrentGrowth)
+        {
+          grow(v);
+        }
+        OutEdgeList &out = g.vList[v].eOut;
+        for (std::size_t j = outStart[v]; j != outStart[v + 1]; ++j)
+        {
+          const auto [src, tar] = batch[outOrder[j]];
+          // For undirected graphs v may be either end-point
+          out.emplace_back(src == v ? tar : src, base + outOrder[j]);
+        }
+        if constexpr (isBidirectional)
+        {
+          InEdgeList &in = g.vList[v].eIn;
+          for (std::size_t j = inStart[v]; j != inStart[v + 1]; ++j)
+          {
+            in.emplace_back(batch[inOrder[j]].first, base + inOrder[j]);
+          }
+        }
+      }, 1 << 12, pool);
+      g.eList.resize(base + batch.size());
+      parallelFor(0, batch.size(), [&](std::size_t i)
+      {
+        g.eList[base + i].src = batch[i].first;
+        g.eList[base + i].tar = batch[i].second;
+      }, 1 << 12, pool);
     }
 
   public: // MutablePropertyGraph
@@ -601,16 +832,17 @@ namespace graph
     /// @return A descriptor for the newly added vertex
     friend VertexDescriptor addVertex(VertexProp vp, AdjacencyList &g)
     {
-      OutEdgeList out;
-      InEdgeList in;
+      // The index of the new vertex must be representable by IndexT
+      assert(g.vList.size() < std::numeric_limits<IndexT>::max());
+
       // Add a vertex and return a descriptor representing the newly added vertex
       if constexpr (std::is_same_v<tags::Bidirectional, DirectedCategory>)
       {
-        g.vList.emplace_back(out, in, vp);
+        g.vList.emplace_back(OutEdgeList(), InEdgeList(), std::move(vp));
       }
       else
       {
-        g.vList.emplace_back(out, vp);
+        g.vList.emplace_back(OutEdgeList(), std::move(vp));
       }
       return g.vList.size() - 1;
     }
@@ -620,35 +852,53 @@ namespace graph
     /// @param v The target vertex
     /// @param ep The edge property
     /// @param g The graph to which the edge is added
-    /// @return A descriptor for the newly added edge
+    /// @return A descriptor for the newly added edge. With an edge index, if (u, v) is
+    ///         already in g nothing is added and the existing edge is returned.
     friend EdgeDescriptor addEdge(VertexDescriptor u, VertexDescriptor v, EdgeProp ep, AdjacencyList &g)
     {
       // Both u and v are valid vertex descriptors for g
-      assert(u <= g.vList.size() && v <= g.vList.size());
+      assert(u < g.vList.size() && v < g.vList.size());
+
+      // The index of the new edge must be representable by IndexT
+      assert(g.eList.size() < std::numeric_limits<IndexT>::max());
 
       // u and v are different
       assert(u != v);
 
-      // No edge (u, v) exist already in g
-      for (auto it = g.eList.begin(); it != g.eList.end;
-           ++it)
-      { // use iterator to iterate through each edge
-        assert(it->src != u && it->tar != v);
+      if constexpr (hasEdgeIndex)
+      {
+        // A duplicate is rejected by returning the edge that is already in g
+        const auto [src, tar] = edgeKey(u, v);
+        const auto [idx, inserted] = g.eIndex.insert(src, tar, g.eList.size());
+        if (!inserted)
+        {
+          return EdgeDescriptor(u, v, idx);
+        }
+      }
+      else
+      {
+#ifndef NDEBUG
+        // No edge (u, v) exist already in g
+        for (const auto &it : g.eList)
+        { // use iterator to iterate through each edge
+          assert(!(it.src == u && it.tar == v));
+        }
+#endif
       }
 
       // Put edge into list of out-edges of u
-      g.eList.emplace_back(u, v, ep);
+      g.eList.emplace_back(u, v, std::move(ep));
 
       EdgeDescriptor edge = EdgeDescriptor(u, v, g.eList.size() - 1);
-      g.vList[u].eOut.emplace_back(edge);
+      g.lists.emplaceBack(g.vList[u].eOut, v, edge.storedEdgeIdx);
 
       if constexpr (std::is_same_v<DirectedCategory, tags::Bidirectional>)
       {
-        g.vList[v].eIn.emplace_back(edge);
+        g.lists.emplaceBack(g.vList[v].eIn, u, edge.storedEdgeIdx);
       }
       if constexpr (std::is_same_v<DirectedCategory, tags::Undirected>)
       {
-        g.vList[v].eOut.emplace_back(edge);
+        g.lists.emplaceBack(g.vList[v].eOut, u, edge.storedEdgeIdx);
       }
 
       return edge;
@@ -667,14 +917,28 @@ namespace graph
 
     EdgeProp &operator[](EdgeDescriptor e)
     {
-      return eList[e].ep;
+      return eList[e.storedEdgeIdx].ep;
     }
 
     const EdgeProp &operator[](EdgeDescriptor e) const
     {
-      return eList[e].ep;
+      return eList[e.storedEdgeIdx].ep;
     }
   };
+
+  /// @brief  An AdjacencyList with 32-bit vertex and edge indices, for graphs with fewer than 2^32
+  ///         vertices and edges, where descriptors and stored edges take half the memory
+  template <typename DirectedCategoryT,
+            typename VertexPropT = NoProp, typename EdgePropT = NoProp,
+            typename EdgeIndexT = NoEdgeIndex>
+  using CompactAdjacencyList = AdjacencyList<DirectedCategoryT, VertexPropT, EdgePropT, EdgeIndexT, std::uint32_t>;
+
+  /// @brief  An AdjacencyList whose edge lists keep their first few edges inline and take the rest
+  ///         from an arena, so vertices of low degree allocate nothing, see ArenaEdgeLists
+  template <typename DirectedCategoryT,
+            typename VertexPropT = NoProp, typename EdgePropT = NoProp,
+            typename EdgeIndexT = NoEdgeIndex, typename IndexT = std::size_t>
+  using ArenaAdjacencyList = AdjacencyList<DirectedCategoryT, VertexPropT, EdgePropT, EdgeIndexT, IndexT, ArenaEdgeLists<>>;
 } // namespace graph
 
 #endif // GRAPH_ADJACENCY_LIST_HPP
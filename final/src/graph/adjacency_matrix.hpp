@@ -6,10 +6,11 @@
 #include "properties.hpp"
 
 #include <boost/iterator/counting_iterator.hpp>
-#include <boost/iterator/filter_iterator.hpp>
-#include <boost/iterator/iterator_adaptor.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 
+#include <bit>
 #include <cassert>
+#include <cstdint>
 #include <tuple>
 #include <vector>
 
@@ -17,11 +18,13 @@ namespace graph {
 
 struct AdjacencyMatrix {
 private:
-	struct StoredEdge {
-		bool exists = false;
-	};
-	using Matrix = std::vector<StoredEdge>;
-	using MatrixIterator = typename Matrix::const_iterator;
+	// The matrix is stored row-major as bits, packed into 64-bit words.
+	// Each row starts at a new word, so row v is the words
+	// v * stride through (v + 1) * stride - 1, and the padding bits
+	// at the end of a row are always zero.
+	using Word = std::uint64_t;
+	static constexpr std::size_t wordBits = 64;
+	using Matrix = std::vector<Word>;
 public: // Graph
 	using VertexDescriptor = std::size_t;
 
@@ -49,70 +52,63 @@ public: // VertexList
 	};
 public: // EdgeList
 	struct EdgeRange {
-		// In the iterator, we want first adapt the MatrixIterator
-		// (which iterates through StoredEdges) to give EdgeDescirptors,
-		// and then skip those that don't exist in the graph.
-		// First: adapt the iterator for the matrix (which is a vector::iterator).
-		struct MatrixAdaptorIterator : boost::iterator_adaptor<
-				MatrixAdaptorIterator, // because we use CRTP
-				MatrixIterator, // the iterator we adapt
-				// we want to convert the StoredEdge into an EdgeDescriptor:
-				EdgeDescriptor,
-				// we can use RA as the underlying iterator supports it:
-				std::random_access_iterator_tag,
+		// The iterator visits the set bits of the words [word, last) in order.
+		// It keeps the not yet visited bits of the current word, and finds the
+		// next edge with count-trailing-zeros, so a row without edges
+		// is skipped 64 entries at a time.
+		struct iterator : boost::iterator_facade<
+				iterator, // because we use CRTP
+				EdgeDescriptor, // the value type
+				std::forward_iterator_tag,
 				// when we dereference we return by value, not by reference:
-				EdgeDescriptor 
+				EdgeDescriptor
 		> {
-			using Base = boost::iterator_adaptor<
-				MatrixAdaptorIterator, MatrixIterator, EdgeDescriptor,
-				std::random_access_iterator_tag, EdgeDescriptor>;
 		public:
-			MatrixAdaptorIterator(const MatrixIterator &i,
-			                      const MatrixIterator &first,
-			                      std::size_t n)
-				: Base(i), first(first), n(n) {}
+			iterator() = default;
+			iterator(const Word *words, std::size_t word, std::size_t last, std::size_t stride)
+				: words(words), word(word), last(last), stride(stride), bits(0) {
+				if(word != last) {
+					bits = words[word];
+					skipEmptyWords();
+				}
+			}
 		private:
 			// let the Boost machinery use our methods
 			friend class boost::iterator_core_access;
 
 			EdgeDescriptor dereference() const {
-				// get our current position stored in the
-				// boost::iterator_adaptor base class
-				const MatrixIterator &i = this->base_reference();
-				const auto idx = i - first;
-				// then calculate the row/src and column/tar
-				const auto src = idx / n;
-				const auto tar = idx % n;
-				return EdgeDescriptor{src, tar, i->exists};
+				// the row is the src, the bit position in the row the tar
+				const std::size_t src = word / stride;
+				const std::size_t tar = (word % stride) * wordBits + std::countr_zero(bits);
+				return EdgeDescriptor{src, tar, true};
+			}
+
+			bool equal(const iterator &other) const {
+				return word == other.word && bits == other.bits;
 			}
-		public:
-			MatrixIterator first;
-			std::size_t n;
-		};
 
-		// Now wrap the matrix iterator such that entries
-		// without an edge are skipped.
-		struct EdgeExistPred {
-			bool operator()(const EdgeDescriptor &e) const {
-				return e.exists;
+			void increment() {
+				bits &= bits - 1; // clear the lowest set bit
+				skipEmptyWords();
 			}
+
+			void skipEmptyWords() {
+				while(bits == 0 && ++word != last) bits = words[word];
+			}
+		private:
+			const Word *words;
+			std::size_t word, last, stride;
+			Word bits;
 		};
-		using iterator = boost::filter_iterator<EdgeExistPred, MatrixAdaptorIterator>;
 	public:
 		EdgeRange(const AdjacencyMatrix *g) : g(g) { }
 
 		iterator begin() const {
-			return iterator(
-				MatrixAdaptorIterator(g->matrix.begin(), g->matrix.begin(), g->n),
-				MatrixAdaptorIterator(g->matrix.end(), g->matrix.begin(), g->n)
-			);
+			return iterator(g->matrix.data(), 0, g->matrix.size(), g->stride);
 		}
 
 		iterator end() const {
-			return iterator(
-				MatrixAdaptorIterator(g->matrix.end(), g->matrix.begin(), g->n),
-				MatrixAdaptorIterator(g->matrix.end(), g->matrix.begin(), g->n)
-			);
+			return iterator(g->matrix.data(), g->matrix.size(), g->matrix.size(), g->stride);
 		}
 	private:
 		const AdjacencyMatrix *g;
@@ -122,47 +118,36 @@ public: // Incidence
 		// we can reuse the EdgeRange::iterator
 		// as the out-edges are simply a sub-range of the edges.
 		// For example, in the following adj. matrix (. means no edge, e means edge)
-		// stored in row-major in the underlying vector, then a row is the out-edges
+		// stored in row-major in the underlying words, then a row is the out-edges
 		// for that vertex, which is a subrange of the underlying vector
 		//   0 1 2 3 4 ... n-1
-		// 0 . e . e e          entires  0 through  n-1 of the vector
-		// 1 e . e e e          entries  n through 2n-1 of the vector
-		// 2 . e . . .          entries 2n through 3n-1 of the vector
+		// 0 . e . e e          words  0        through   stride-1
+		// 1 e . e e e          words  stride   through 2*stride-1
+		// 2 . e . . .          words 2*stride  through 3*stride-1
 		// ...
 		using iterator = typename EdgeRange::iterator;
 	public:
 		OutEdgeRange(VertexDescriptor v, const AdjacencyMatrix &g) : src(v), g(&g) { }
 
 		iterator begin() const {
-			// src is the row number, each row has n entries
-			auto first = g->matrix.begin() + src * g->n;
-			auto last = g->matrix.begin() + (src + 1) * g->n;
-			return iterator(
-				typename EdgeRange::MatrixAdaptorIterator(
-					first, g->matrix.begin(), g->n),
-				typename EdgeRange::MatrixAdaptorIterator(
-					last,  g->matrix.begin(), g->n)
-			);
-		}	
-		
+			// src is the row number, each row has stride words
+			return iterator(g->matrix.data(), src * g->stride, (src + 1) * g->stride, g->stride);
+		}
+
 		iterator end() const {
-			// src is the row number, each row has n entries
-			auto last = g->matrix.begin() + (src + 1) * g->n;
-			return iterator(
-				typename EdgeRange::MatrixAdaptorIterator(
-					last, g->matrix.begin(), g->n),
-				typename EdgeRange::MatrixAdaptorIterator(
-					last, g->matrix.begin(), g->n)
-			);
+			const std::size_t last = (src + 1) * g->stride;
+			return iterator(g->matrix.data(), last, last, g->stride);
 		}
 	private:
 		std::size_t src;
 		const AdjacencyMatrix *g;
-	};	
+	};
 public:
-	AdjacencyMatrix(std::size_t n) : n(n), matrix(n * n) {}
+	AdjacencyMatrix(std::size_t n)
+		: n(n), stride((n + wordBits - 1) / wordBits), matrix(n * stride) {}
 private:
 	std::size_t n;
+	std::size_t stride; // words per row
 	std::size_t m = 0;
 	Matrix matrix;
 public: // Graph
@@ -193,8 +178,11 @@ public: // EdgeList
 	}
 public: // Incidence
 	friend std::size_t outDegree(VertexDescriptor v, const AdjacencyMatrix &g) {
-		auto oe = outEdges(v, g);
-		return std::distance(oe.begin(), oe.end());
+		// count the set bits of the row, a word at a time
+		std::size_t d = 0;
+		for(std::size_t w = v * g.stride; w != (v + 1) * g.stride; ++w)
+			d += std::popcount(g.matrix[w]);
+		return d;
 	}
 
 	friend OutEdgeRange outEdges(VertexDescriptor v, const AdjacencyMatrix &g) {
@@ -203,9 +191,12 @@ public: // Incidence
 public: // Mutable
 	friend EdgeDescriptor addEdge(VertexDescriptor src, VertexDescriptor tar,
 	                              AdjacencyMatrix &g) {
-		if(g.matrix[src * g.n + tar].exists) assert(false);
+		assert(src < g.n && tar < g.n);
+		Word &word = g.matrix[src * g.stride + tar / wordBits];
+		const Word bit = Word(1) << (tar % wordBits);
+		if(word & bit) assert(false);
 		++g.m;
-		g.matrix[src * g.n + tar].exists = true;
+		word |= bit;
 		return EdgeDescriptor{src, tar, true};
 	}
 public: // Other
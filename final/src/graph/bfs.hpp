@@ -0,0 +1,235 @@
+#ifndef GRAPH_BFS_HPP
+#define GRAPH_BFS_HPP
+
+#include "concepts.hpp"
+#include "parallel.hpp"
+#include "traits.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <queue>
+#include <type_traits>
+#include <vector>
+
+namespace graph {
+
+struct BFSNullVisitor {
+	template<typename G, typename V>
+	void initVertex(const V &, const G &) {}
+
+	template<typename G, typename V>
+	void discoverVertex(const V &, const G &) {}
+
+	template<typename G, typename V>
+	void examineVertex(const V &, const G &) {}
+
+	template<typename G, typename V>
+	void finishVertex(const V &, const G &) {}
+
+	template<typename G, typename E>
+	void examineEdge(const E &, const G &) {}
+
+	template<typename G, typename E>
+	void treeEdge(const E &, const G &) {}
+
+	template<typename G, typename E>
+	void nonTreeEdge(const E &, const G &) {}
+
+	template<typename G, typename E>
+	void greyTarget(const E &, const G &) {}
+
+	template<typename G, typename E>
+	void blackTarget(const E &, const G &) {}
+};
+
+// The distance parallelBfs gives vertices that are not reachable from the source.
+inline constexpr std::size_t unreachable = std::numeric_limits<std::size_t>::max();
+
+namespace detail {
+
+enum struct BFSColour {
+	White, Grey, Black
+};
+
+} // namespace detail
+
+// Breadth-first search from s, calling the event points of visitor.
+// Every vertex gets initVertex, then the vertices reachable from s are discovered
+// in order of their distance from s. When a vertex is taken from the queue its
+// out-edges are examined, and each of them is either a tree edge to a newly
+// discovered vertex, or a non-tree edge to a grey (queued) or black (finished) vertex.
+template<typename Graph, typename Visitor>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph>
+void bfs(const Graph &g, typename Traits<Graph>::VertexDescriptor s, Visitor visitor) {
+	using Vertex = typename Traits<Graph>::VertexDescriptor;
+	using detail::BFSColour;
+	std::vector<BFSColour> colour(numVertices(g), BFSColour::White);
+	for(Vertex u : vertices(g))
+		visitor.initVertex(u, g);
+	std::queue<Vertex> queue;
+	colour[getIndex(s, g)] = BFSColour::Grey;
+	visitor.discoverVertex(s, g);
+	queue.push(s);
+	while(!queue.empty()) {
+		const Vertex u = queue.front();
+		queue.pop();
+		visitor.examineVertex(u, g);
+		for(const auto &e : outEdges(u, g)) {
+			const Vertex v = target(e, g);
+			visitor.examineEdge(e, g);
+			BFSColour &c = colour[getIndex(v, g)];
+			if(c == BFSColour::White) {
+				visitor.treeEdge(e, g);
+				c = BFSColour::Grey;
+				visitor.discoverVertex(v, g);
+				queue.push(v);
+			} else {
+				visitor.nonTreeEdge(e, g);
+				if(c == BFSColour::Grey) visitor.greyTarget(e, g);
+				else visitor.blackTarget(e, g);
+			}
+		}
+		colour[getIndex(u, g)] = BFSColour::Black;
+		visitor.finishVertex(u, g);
+	}
+}
+
+// Parallel direction-optimizing BFS from s.
+// Sets distance[getIndex(v, g)] to the number of edges on a shortest path from s to v,
+// and parent[getIndex(v, g)] to the index of the vertex before v on such a path
+// (s is its own parent). Both are unreachable for vertices not reachable from s.
+//
+// The levels are expanded either top-down, where the frontier claims the unvisited
+// targets of its out-edges, or bottom-up, where every unvisited vertex scans its
+// in-edges for a frontier vertex and stops at the first one found.
+// Bottom-up steps are taken while the frontier has many edges compared to the
+// unvisited part of the graph, which in low-diameter graphs skips most of the
+// edges of the big middle levels. They need the in-edges, so only undirected graphs
+// and graphs modelling BidirectionalGraph use them, other graphs go top-down only.
+// The distances are deterministic, the parents may depend on the thread schedule.
+template<typename Graph>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph>
+void parallelBfs(const Graph &g, typename Traits<Graph>::VertexDescriptor s,
+                 std::vector<std::size_t> &distance, std::vector<std::size_t> &parent,
+                 ThreadPool &pool = defaultThreadPool()) {
+	using Vertex = typename Traits<Graph>::VertexDescriptor;
+	constexpr bool isUndirected = std::is_same_v<typename Traits<Graph>::DirectedCategory, tags::Undirected>;
+	// the switching thresholds of Beamer et al., Direction-Optimizing Breadth-First Search
+	constexpr std::size_t alpha = 15, beta = 18;
+	constexpr std::size_t grain = 1 << 10;
+	const std::size_t n = numVertices(g);
+
+	std::vector<Vertex> vs(n);
+	for(Vertex v : vertices(g)) vs[getIndex(v, g)] = v;
+	distance.assign(n, unreachable);
+	parent.assign(n, unreachable);
+
+	// the sum of the out-degrees of the vertices not yet reached
+	std::atomic<std::size_t> unvisitedEdges{0};
+	parallelBlocks(0, n, grain, [&](std::size_t, std::size_t first, std::size_t last) {
+		std::size_t sum = 0;
+		for(std::size_t i = first; i != last; ++i) sum += outDegree(vs[i], g);
+		unvisitedEdges += sum;
+	}, pool);
+
+	// The frontier is a list of indices in top-down steps and a bitmap in bottom-up steps.
+	const std::size_t si = getIndex(s, g);
+	std::vector<std::size_t> queue{si};
+	std::vector<char> inFrontier, inNext;
+	std::size_t frontierSize = 1, frontierEdges = outDegree(s, g);
+	distance[si] = 0;
+	parent[si] = si;
+	unvisitedEdges -= frontierEdges;
+	bool bottomUp = false;
+
+	for(std::size_t depth = 1; frontierSize != 0; ++depth) {
+		if constexpr(isUndirected || BidirectionalGraph<Graph>) {
+			if(!bottomUp && frontierEdges > unvisitedEdges / alpha) {
+				bottomUp = true;
+				inFrontier.assign(n, 0);
+				for(std::size_t u : queue) inFrontier[u] = 1;
+				queue.clear();
+			} else if(bottomUp && frontierSize < n / beta && frontierEdges <= unvisitedEdges / alpha) {
+				bottomUp = false;
+				for(std::size_t u = 0; u != n; ++u)
+					if(inFrontier[u]) queue.push_back(u);
+			}
+
+			if(bottomUp) {
+				inNext.assign(n, 0);
+				std::atomic<std::size_t> nextSize{0}, nextEdges{0};
+				parallelBlocks(0, n, grain, [&](std::size_t, std::size_t first, std::size_t last) {
+					std::size_t size = 0, edges = 0;
+					// only the block of v writes to the entries of v
+					auto found = [&](std::size_t v, std::size_t u) {
+						if(!inFrontier[u]) return false;
+						distance[v] = depth;
+						parent[v] = u;
+						inNext[v] = 1;
+						++size;
+						edges += outDegree(vs[v], g);
+						return true;
+					};
+					for(std::size_t v = first; v != last; ++v) {
+						if(distance[v] != unreachable) continue;
+						if constexpr(isUndirected) {
+							for(const auto &e : outEdges(vs[v], g))
+								if(found(v, getIndex(target(e, g), g))) break;
+						} else {
+							for(const auto &e : inEdges(vs[v], g))
+								if(found(v, getIndex(source(e, g), g))) break;
+						}
+					}
+					nextSize += size;
+					nextEdges += edges;
+				}, pool);
+				inFrontier.swap(inNext);
+				frontierSize = nextSize;
+				frontierEdges = nextEdges;
+				unvisitedEdges -= frontierEdges;
+				continue;
+			}
+		}
+
+		std::vector<std::vector<std::size_t>> local(numBlocks(queue.size(), grain, pool));
+		std::atomic<std::size_t> nextEdges{0};
+		parallelBlocks(0, queue.size(), grain, [&](std::size_t block, std::size_t first, std::size_t last) {
+			std::size_t edges = 0;
+			for(std::size_t k = first; k != last; ++k) {
+				const std::size_t u = queue[k];
+				for(const auto &e : outEdges(vs[u], g)) {
+					const std::size_t v = getIndex(target(e, g), g);
+					std::atomic_ref<std::size_t> d(distance[v]);
+					std::size_t expected = unreachable;
+					// only the thread that claims v writes its parent
+					if(d.load(std::memory_order_relaxed) == unreachable
+					   && d.compare_exchange_strong(expected, depth, std::memory_order_relaxed)) {
+						parent[v] = u;
+						local[block].push_back(v);
+						edges += outDegree(vs[v], g);
+					}
+				}
+			}
+			nextEdges += edges;
+		}, pool);
+		queue.clear();
+		for(const auto &l : local) queue.insert(queue.end(), l.begin(), l.end());
+		frontierSize = queue.size();
+		frontierEdges = nextEdges;
+		unvisitedEdges -= frontierEdges;
+	}
+}
+
+// As above, without the parents.
+template<typename Graph>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph>
+void parallelBfs(const Graph &g, typename Traits<Graph>::VertexDescriptor s,
+                 std::vector<std::size_t> &distance, ThreadPool &pool = defaultThreadPool()) {
+	std::vector<std::size_t> parent;
+	parallelBfs(g, s, distance, parent, pool);
+}
+
+} // namespace graph
+
+#endif // GRAPH_BFS_HPP
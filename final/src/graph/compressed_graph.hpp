@@ -0,0 +1,443 @@
+#ifndef GRAPH_COMPRESSED_GRAPH_HPP
+#define GRAPH_COMPRESSED_GRAPH_HPP
+
+#include "concepts.hpp"
+#include "properties.hpp"
+#include "tags.hpp"
+#include "traits.hpp"
+
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/filter_iterator.hpp>
+#include <boost/iterator/iterator_adaptor.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <cassert>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// An immutable graph in compressed sparse row (CSR) format.
+// The out-edges of vertex v are the entries offsets[v] through offsets[v + 1] - 1
+// of one contiguous targets array, so scanning the neighbours of a vertex is
+// a linear walk through memory.
+// - For tags::Undirected each edge is stored in the rows of both end-points,
+//   and an extra array maps each entry back to the id of the edge.
+// - For tags::Bidirectional a second, transposed, CSR holds the in-edges,
+//   together with the id of the corresponding out-edge entry.
+// The graph is built once, either from another graph or from an edge list,
+// and the order of the out-edges of each vertex follows the order of the input.
+// The arrays are views into storage shared by all copies of the graph, which is
+// either owned vectors or, see openBinary in io.hpp, a memory-mapped file.
+// Optional vertex and edge properties are stored in arrays indexed by
+// vertex and edge id, and are read-only.
+template<typename DirectedCategoryT, typename VertexPropT = NoProp, typename EdgePropT = NoProp>
+struct CompressedGraph {
+private:
+	static constexpr bool isUndirected = std::is_same_v<DirectedCategoryT, tags::Undirected>;
+	static constexpr bool isBidirectional = std::is_same_v<DirectedCategoryT, tags::Bidirectional>;
+	static constexpr bool hasVertexProps = !std::is_same_v<VertexPropT, NoProp>;
+	static constexpr bool hasEdgeProps = !std::is_same_v<EdgePropT, NoProp>;
+	using Array = std::vector<std::size_t>;
+	using Span = std::span<const std::size_t>;
+	using ArrayIterator = typename Span::iterator;
+public: // PropertyGraph
+	using VertexProp = VertexPropT;
+	using EdgeProp = EdgePropT;
+public:
+	// The arrays making up the graph.
+	struct Arrays {
+		std::size_t numEdges = 0;
+		Span offsets;   // n + 1 row starts into targets
+		Span targets;   // the target of each out-edge entry
+		Span edgeIds;   // Undirected only: the edge id of each entry
+		Span inOffsets; // Bidirectional only: n + 1 row starts into inSources
+		Span inSources; // Bidirectional only: the source of each in-edge entry
+		Span inEdgeIds; // Bidirectional only: the out-edge entry of each in-edge entry
+		std::span<const VertexProp> vertexProps; // unless NoProp: the property of each vertex
+		std::span<const EdgeProp> edgeProps;     // unless NoProp: the property of each edge id
+	};
+public: // Graph
+	using DirectedCategory = DirectedCategoryT;
+	using VertexDescriptor = std::size_t;
+
+	struct EdgeDescriptor {
+		EdgeDescriptor() = default;
+		EdgeDescriptor(std::size_t src, std::size_t tar, std::size_t idx)
+			: src(src), tar(tar), idx(idx) {}
+	public:
+		std::size_t src, tar;
+		std::size_t idx; // the id of the edge, in the range [0, numEdges)
+	public:
+		// Two descriptors denote the same edge if they have the same id,
+		// so for undirected graphs (u, v) and (v, u) compare equal.
+		friend bool operator==(const EdgeDescriptor &a, const EdgeDescriptor &b) {
+			return a.idx == b.idx;
+		}
+	};
+public: // VertexList
+	struct VertexRange {
+		// the iterator is simply a counter that returns its value when dereferenced
+		using iterator = boost::counting_iterator<VertexDescriptor>;
+	public:
+		VertexRange(std::size_t n) : n(n) {}
+		iterator begin() const { return iterator(0); }
+		iterator end()   const { return iterator(n); }
+	private:
+		std::size_t n;
+	};
+public: // Incidence
+	struct OutEdgeRange {
+		// Adapt the iterator of the targets array, so it dereferences
+		// to EdgeDescriptors with the fixed source of the range.
+		struct iterator : boost::iterator_adaptor<
+				iterator, // because we use CRTP
+				ArrayIterator, // the iterator we adapt
+				// we want to convert the target into an EdgeDescriptor:
+				EdgeDescriptor,
+				// we can use RA as the underlying iterator supports it:
+				std::random_access_iterator_tag,
+				// when we dereference we return by value, not by reference:
+				EdgeDescriptor
+		> {
+			using Base = boost::iterator_adaptor<
+				iterator, ArrayIterator, EdgeDescriptor,
+				std::random_access_iterator_tag, EdgeDescriptor>;
+		public:
+			iterator() = default;
+			iterator(ArrayIterator i, VertexDescriptor src, const CompressedGraph *g)
+				: Base(i), src(src), g(g) {}
+		private:
+			// let the Boost machinery use our methods
+			friend class boost::iterator_core_access;
+
+			EdgeDescriptor dereference() const {
+				const ArrayIterator &i = this->base_reference();
+				const std::size_t entry = i - g->csr.targets.begin();
+				return EdgeDescriptor{src, *i, g->entryToEdge(entry)};
+			}
+		private:
+			VertexDescriptor src;
+			const CompressedGraph *g;
+		};
+	public:
+		OutEdgeRange(VertexDescriptor v, const CompressedGraph &g) : src(v), g(&g) {}
+
+		iterator begin() const {
+			return iterator(g->csr.targets.begin() + g->csr.offsets[src], src, g);
+		}
+
+		iterator end() const {
+			return iterator(g->csr.targets.begin() + g->csr.offsets[src + 1], src, g);
+		}
+	private:
+		VertexDescriptor src;
+		const CompressedGraph *g;
+	};
+public: // EdgeList
+	struct EdgeRange {
+		// We walk all entries of the targets array while tracking the current row,
+		// which is the source of the edge.
+		struct EntryIterator : boost::iterator_facade<
+				EntryIterator, EdgeDescriptor,
+				std::forward_iterator_tag, EdgeDescriptor> {
+		public:
+			EntryIterator() = default;
+			EntryIterator(std::size_t entry, VertexDescriptor src, const CompressedGraph *g)
+				: entry(entry), src(src), g(g) {
+				skipEmptyRows();
+			}
+		private:
+			friend class boost::iterator_core_access;
+
+			EdgeDescriptor dereference() const {
+				return EdgeDescriptor{src, g->csr.targets[entry], g->entryToEdge(entry)};
+			}
+
+			bool equal(const EntryIterator &other) const {
+				return entry == other.entry;
+			}
+
+			void increment() {
+				++entry;
+				skipEmptyRows();
+			}
+
+			// Advance src to the row containing entry.
+			void skipEmptyRows() {
+				const std::size_t n = g->csr.offsets.size() - 1;
+				while(src < n && g->csr.offsets[src + 1] <= entry) ++src;
+			}
+		private:
+			std::size_t entry;
+			VertexDescriptor src;
+			const CompressedGraph *g;
+		};
+
+		// Undirected edges are stored twice, so only report the copy
+		// where the source is the smaller end-point.
+		struct CanonicalPred {
+			bool operator()(const EdgeDescriptor &e) const {
+				if constexpr(isUndirected) return e.src < e.tar;
+				else return true;
+			}
+		};
+		using iterator = boost::filter_iterator<CanonicalPred, EntryIterator>;
+	public:
+		EdgeRange(const CompressedGraph *g) : g(g) {}
+
+		iterator begin() const {
+			return iterator(EntryIterator(0, 0, g), last());
+		}
+
+		iterator end() const {
+			return iterator(last(), last());
+		}
+	private:
+		EntryIterator last() const {
+			return EntryIterator(g->csr.targets.size(), numVertices(*g), g);
+		}
+	private:
+		const CompressedGraph *g;
+	};
+public: // Bidirectional
+	struct InEdgeRange {
+		// Adapt the iterator of the transposed sources array, so it dereferences
+		// to EdgeDescriptors with the fixed target of the range.
+		struct iterator : boost::iterator_adaptor<
+				iterator, ArrayIterator, EdgeDescriptor,
+				std::random_access_iterator_tag, EdgeDescriptor> {
+			using Base = boost::iterator_adaptor<
+				iterator, ArrayIterator, EdgeDescriptor,
+				std::random_access_iterator_tag, EdgeDescriptor>;
+		public:
+			iterator() = default;
+			iterator(ArrayIterator i, VertexDescriptor tar, const CompressedGraph *g)
+				: Base(i), tar(tar), g(g) {}
+		private:
+			friend class boost::iterator_core_access;
+
+			EdgeDescriptor dereference() const {
+				const ArrayIterator &i = this->base_reference();
+				const std::size_t entry = i - g->csr.inSources.begin();
+				return EdgeDescriptor{*i, tar, g->csr.inEdgeIds[entry]};
+			}
+		private:
+			VertexDescriptor tar;
+			const CompressedGraph *g;
+		};
+	public:
+		InEdgeRange(VertexDescriptor v, const CompressedGraph &g) : tar(v), g(&g) {}
+
+		iterator begin() const {
+			return iterator(g->csr.inSources.begin() + g->csr.inOffsets[tar], tar, g);
+		}
+
+		iterator end() const {
+			return iterator(g->csr.inSources.begin() + g->csr.inOffsets[tar + 1], tar, g);
+		}
+	private:
+		VertexDescriptor tar;
+		const CompressedGraph *g;
+	};
+public:
+	// Constructs a graph with no vertices.
+	CompressedGraph() {
+		csr.offsets = Span(emptyOffsets);
+		if constexpr(isBidirectional) csr.inOffsets = Span(emptyOffsets);
+	}
+
+	// Constructs a graph with n vertices and the edges in [first, last).
+	// Each element must be destructurable into a source and a target index,
+	// e.g., a std::pair<std::size_t, std::size_t>. Properties are value-initialized.
+	// Requires two passes over the range: one to count degrees and one to fill.
+	template<std::forward_iterator EdgeIter>
+	CompressedGraph(std::size_t n, EdgeIter first, EdgeIter last) {
+		build(n, std::distance(first, last), [&](auto &&emit) {
+			for(EdgeIter it = first; it != last; ++it) {
+				const auto &[src, tar] = *it;
+				emit(static_cast<std::size_t>(src), static_cast<std::size_t>(tar), nullptr);
+			}
+		}, [](auto&&) {});
+	}
+
+	// Constructs a compressed copy of g, e.g., an AdjacencyList or AdjacencyMatrix.
+	// Vertices are renumbered by getIndex, and the out-edges of each vertex
+	// keep the relative order in which edges(g) reports them.
+	// Properties, if any, are copied with g[v] and g[e].
+	template<typename G>
+		requires VertexListGraph<G> && EdgeListGraph<G>
+	explicit CompressedGraph(const G &g) {
+		build(numVertices(g), numEdges(g), [&](auto &&emit) {
+			for(auto e : edges(g)) {
+				const EdgeProp *ep = nullptr;
+				if constexpr(hasEdgeProps) ep = &g[e];
+				emit(getIndex(source(e, g), g), getIndex(target(e, g), g), ep);
+			}
+		}, [&](std::vector<VertexProp> &vertexProps) {
+			if constexpr(hasVertexProps) {
+				for(auto v : vertices(g))
+					vertexProps[getIndex(v, g)] = g[v];
+			}
+		});
+	}
+
+	// Constructs a graph that views the given arrays, which must stay valid
+	// as long as storage is alive, e.g., because storage owns a memory mapping.
+	CompressedGraph(std::shared_ptr<const void> storage, const Arrays &arrays)
+		: storage(std::move(storage)), csr(arrays) {
+		assert(!csr.offsets.empty() && csr.targets.size() == csr.offsets.back());
+		assert(!isBidirectional || csr.inOffsets.size() == csr.offsets.size());
+	}
+
+	// The arrays of the graph, e.g., for saving it.
+	const Arrays &arrays() const {
+		return csr;
+	}
+private:
+	// The vectors backing a graph built in memory.
+	struct OwnedArrays {
+		Array offsets, targets, edgeIds, inOffsets, inSources, inEdgeIds;
+		std::vector<VertexProp> vertexProps;
+		std::vector<EdgeProp> edgeProps;
+	};
+
+	// Two-pass counting sort of the edges produced by forEachEdge into rows,
+	// followed by setVertexProps to fill in the vertex properties, if any.
+	template<typename ForEachEdge, typename SetVertexProps>
+	void build(std::size_t n, std::size_t m, ForEachEdge forEachEdge, SetVertexProps setVertexProps) {
+		auto owned = std::make_shared<OwnedArrays>();
+		Array &offsets = owned->offsets, &targets = owned->targets, &edgeIds = owned->edgeIds;
+		Array &inOffsets = owned->inOffsets, &inSources = owned->inSources, &inEdgeIds = owned->inEdgeIds;
+		offsets.assign(n + 1, 0);
+		if constexpr(isBidirectional) inOffsets.assign(n + 1, 0);
+		// First pass: count the degrees, shifted by one for the prefix sum.
+		forEachEdge([&](std::size_t src, std::size_t tar, const EdgeProp*) {
+			assert(src < n && tar < n);
+			++offsets[src + 1];
+			if constexpr(isUndirected) ++offsets[tar + 1];
+			if constexpr(isBidirectional) ++inOffsets[tar + 1];
+		});
+		for(std::size_t v = 0; v < n; ++v) {
+			offsets[v + 1] += offsets[v];
+			if constexpr(isBidirectional) inOffsets[v + 1] += inOffsets[v];
+		}
+		targets.resize(offsets[n]);
+		if constexpr(isUndirected) edgeIds.resize(offsets[n]);
+		if constexpr(isBidirectional) {
+			inSources.resize(inOffsets[n]);
+			inEdgeIds.resize(inOffsets[n]);
+		}
+		if constexpr(hasVertexProps) owned->vertexProps.resize(n);
+		if constexpr(hasEdgeProps) owned->edgeProps.resize(m);
+		// Second pass: place each edge at the next free slot of its row(s).
+		Array next(offsets.begin(), offsets.end() - 1);
+		Array inNext(inOffsets.begin(), inOffsets.empty() ? inOffsets.end() : inOffsets.end() - 1);
+		std::size_t id = 0;
+		forEachEdge([&](std::size_t src, std::size_t tar, const EdgeProp *ep) {
+			const std::size_t entry = next[src]++;
+			targets[entry] = tar;
+			if constexpr(isUndirected) {
+				assert(src != tar);
+				edgeIds[entry] = id;
+				const std::size_t back = next[tar]++;
+				targets[back] = src;
+				edgeIds[back] = id;
+			}
+			if constexpr(isBidirectional) {
+				const std::size_t inEntry = inNext[tar]++;
+				inSources[inEntry] = src;
+				inEdgeIds[inEntry] = entry;
+			}
+			if constexpr(hasEdgeProps) {
+				if(ep) owned->edgeProps[isUndirected ? id : entry] = *ep;
+			}
+			++id;
+		});
+		assert(id == m);
+		setVertexProps(owned->vertexProps);
+
+		csr.numEdges = m;
+		csr.offsets = Span(offsets);
+		csr.targets = Span(targets);
+		csr.edgeIds = Span(edgeIds);
+		csr.inOffsets = Span(inOffsets);
+		csr.inSources = Span(inSources);
+		csr.inEdgeIds = Span(inEdgeIds);
+		csr.vertexProps = std::span<const VertexProp>(owned->vertexProps);
+		csr.edgeProps = std::span<const EdgeProp>(owned->edgeProps);
+		storage = std::move(owned);
+	}
+
+	// The id of the edge stored at the given entry of the targets array.
+	std::size_t entryToEdge(std::size_t entry) const {
+		if constexpr(isUndirected) return csr.edgeIds[entry];
+		else return entry;
+	}
+private:
+	static constexpr std::size_t emptyOffsets[1] = {0};
+	std::shared_ptr<const void> storage;
+	Arrays csr;
+public: // Graph
+	friend VertexDescriptor source(const EdgeDescriptor &e, const CompressedGraph&) {
+		return e.src;
+	}
+
+	friend VertexDescriptor target(const EdgeDescriptor &e, const CompressedGraph&) {
+		return e.tar;
+	}
+public: // VertexList
+	friend std::size_t numVertices(const CompressedGraph &g) {
+		return g.csr.offsets.size() - 1;
+	}
+
+	friend VertexRange vertices(const CompressedGraph &g) {
+		return VertexRange(numVertices(g));
+	}
+public: // EdgeList
+	friend std::size_t numEdges(const CompressedGraph &g) {
+		return g.csr.numEdges;
+	}
+
+	friend EdgeRange edges(const CompressedGraph &g) {
+		return EdgeRange(&g);
+	}
+public: // Incidence
+	friend OutEdgeRange outEdges(VertexDescriptor v, const CompressedGraph &g) {
+		return OutEdgeRange(v, g);
+	}
+
+	friend std::size_t outDegree(VertexDescriptor v, const CompressedGraph &g) {
+		return g.csr.offsets[v + 1] - g.csr.offsets[v];
+	}
+public: // Bidirectional
+	friend InEdgeRange inEdges(VertexDescriptor v, const CompressedGraph &g)
+		requires isBidirectional {
+		return InEdgeRange(v, g);
+	}
+
+	friend std::size_t inDegree(VertexDescriptor v, const CompressedGraph &g)
+		requires isBidirectional {
+		return g.csr.inOffsets[v + 1] - g.csr.inOffsets[v];
+	}
+public: // Other
+	friend std::size_t getIndex(VertexDescriptor v, const CompressedGraph&) {
+		return v;
+	}
+public: // PropertyGraph, read-only
+	const VertexProp &operator[](VertexDescriptor v) const requires hasVertexProps {
+		return csr.vertexProps[v];
+	}
+
+	const EdgeProp &operator[](const EdgeDescriptor &e) const requires hasEdgeProps {
+		return csr.edgeProps[e.idx];
+	}
+};
+
+} // namespace graph
+
+#endif // GRAPH_COMPRESSED_GRAPH_HPP
@@ -5,6 +5,7 @@
 #include "traits.hpp"
 
 #include <concepts>
+#include <cstddef>
 #include <iterator>
 
 namespace graph {
@@ -162,6 +163,15 @@ concept MutablePropertyGraph =
 		-> std::same_as<typename Traits<G>::EdgeDescriptor>;
 };
 
+template<typename G>
+concept IndexedGraph =
+	Graph<G>
+&& requires(const G &g, typename Traits<G>::VertexDescriptor v) {
+	// Returns the index of v in g, which for a VertexListGraph is in [0, numVertices(g)).
+	// Algorithms use it to keep per-vertex data in arrays.
+	{ getIndex(v, g) } -> std::convertible_to<std::size_t>;
+};
+
 } // namespace graph
 
 #endif // GRAPH_CONCEPTS_HPP
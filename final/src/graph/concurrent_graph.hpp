@@ -0,0 +1,457 @@
+#ifndef GRAPH_CONCURRENT_GRAPH_HPP
+#define GRAPH_CONCURRENT_GRAPH_HPP
+
+#include "compressed_graph.hpp"
+#include "concepts.hpp"
+#include "parallel.hpp"
+#include "tags.hpp"
+#include "traits.hpp"
+
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace graph {
+
+// A graph that many threads can grow at once, for ingesting edges from several producers,
+// followed by freeze, which compacts it into a CompressedGraph for the algorithms.
+// addVertex and addEdge are lock-free and may be called concurrently with each other
+// from any number of threads, as long as the end-points of an edge have been added
+// before, e.g., by the constructor or through a happens-before from their addVertex.
+// Reading the graph, i.e., everything else, requires that no thread is adding to it.
+//
+// The edges of each vertex are kept in a chain of blocks of doubling capacity, newest
+// first. A thread appends by claiming the next slot of the newest block with a fetch_add,
+// and, if the block is full, by pushing a new block with a compare-and-swap on the head
+// of the chain, so threads only contend on the vertices they share. The vertices live in
+// segments of doubling size that are never moved, so addVertex does not invalidate them.
+// - For tags::Undirected each edge is stored in the rows of both end-points.
+// - For tags::Bidirectional a second chain per vertex holds its in-edges.
+// Each edge gets an id in [0, numEdges) in the order its addEdge started. Parallel edges
+// are kept, and the out-edges of a vertex come in no particular order.
+template<typename DirectedCategoryT = tags::Directed>
+class ConcurrentGraph {
+	static constexpr bool isUndirected = std::is_same_v<DirectedCategoryT, tags::Undirected>;
+	static constexpr bool isBidirectional = std::is_same_v<DirectedCategoryT, tags::Bidirectional>;
+
+	struct Entry {
+		std::size_t v; // the other end-point
+		std::size_t id;
+	};
+
+	class Block {
+	public:
+		// Creates a block holding only e.
+		static Block *create(std::uint32_t capacity, Block *next, const Entry &e) {
+			Block *b = new(::operator new(sizeof(Block) + capacity * sizeof(Entry))) Block(capacity, next);
+			b->entries()[0] = e;
+			return b;
+		}
+
+		static void destroy(Block *b) {
+			b->~Block();
+			::operator delete(b);
+		}
+
+		Entry *entries() {
+			return reinterpret_cast<Entry*>(this + 1);
+		}
+
+		const Entry *entries() const {
+			return reinterpret_cast<const Entry*>(this + 1);
+		}
+
+		// The number of filled slots, once no thread is appending.
+		std::uint32_t size() const {
+			return std::min(reserved.load(std::memory_order_relaxed), capacity);
+		}
+	private:
+		Block(std::uint32_t capacity, Block *next) : reserved(1), capacity(capacity), next(next) {}
+	public:
+		std::atomic<std::uint32_t> reserved; // may overshoot capacity, by the appends that failed
+		const std::uint32_t capacity;
+		Block *const next;
+	};
+	static_assert(sizeof(Block) % alignof(Entry) == 0);
+
+	using Head = std::atomic<Block*>;
+
+	struct Vertex {
+		std::array<Head, isBidirectional ? 2 : 1> heads{}; // out-edges, and in-edges
+	};
+
+	static constexpr std::uint32_t firstBlockCapacity = 4, maxBlockCapacity = 1 << 12;
+	static constexpr std::size_t firstSegmentSize = 1 << 10, numSegments = 48;
+public: // Graph
+	using DirectedCategory = DirectedCategoryT;
+	using VertexDescriptor = std::size_t;
+
+	struct EdgeDescriptor {
+		EdgeDescriptor() = default;
+		EdgeDescriptor(std::size_t src, std::size_t tar, std::size_t idx)
+			: src(src), tar(tar), idx(idx) {}
+	public:
+		std::size_t src, tar;
+		std::size_t idx; // the id of the edge, in the range [0, numEdges)
+	public:
+		// Two descriptors denote the same edge if they have the same id,
+		// so for undirected graphs (u, v) and (v, u) compare equal.
+		friend bool operator==(const EdgeDescriptor &a, const EdgeDescriptor &b) {
+			return a.idx == b.idx;
+		}
+	};
+public: // VertexList
+	struct VertexRange {
+		// the iterator is simply a counter that returns its value when dereferenced
+		using iterator = boost::counting_iterator<VertexDescriptor>;
+	public:
+		VertexRange(std::size_t n) : n(n) {}
+		iterator begin() const { return iterator(0); }
+		iterator end()   const { return iterator(n); }
+	private:
+		std::size_t n;
+	};
+private:
+	// The edges in the chain of out-edges or, if isIn, of in-edges, of vertex v.
+	template<bool isIn>
+	struct RowRange {
+		// We walk the slots of each block of the chain in turn.
+		struct iterator : boost::iterator_facade<
+				iterator, EdgeDescriptor,
+				std::forward_iterator_tag, EdgeDescriptor> {
+		public:
+			// also the end of every row
+			iterator() = default;
+
+			iterator(VertexDescriptor v, const Block *b) : v(v), b(b) {
+				if(b) size = b->size();
+			}
+		private:
+			friend class boost::iterator_core_access;
+
+			EdgeDescriptor dereference() const {
+				const Entry &e = b->entries()[k];
+				if constexpr(isIn) return EdgeDescriptor{e.v, v, e.id};
+				else return EdgeDescriptor{v, e.v, e.id};
+			}
+
+			bool equal(const iterator &other) const {
+				return b == other.b && k == other.k;
+			}
+
+			void increment() {
+				if(++k == size) {
+					b = b->next;
+					k = 0;
+					size = b ? b->size() : 0;
+				}
+			}
+		private:
+			VertexDescriptor v = 0;
+			const Block *b = nullptr;
+			std::uint32_t k = 0, size = 0;
+		};
+	public:
+		RowRange(VertexDescriptor v, const Block *b) : v(v), b(b) {}
+
+		iterator begin() const {
+			return iterator(v, b);
+		}
+
+		iterator end() const {
+			return iterator();
+		}
+	private:
+		VertexDescriptor v;
+		const Block *b;
+	};
+public: // Incidence
+	using OutEdgeRange = RowRange<false>;
+public: // Bidirectional
+	using InEdgeRange = RowRange<true>;
+public: // EdgeList
+	struct EdgeRange {
+		// We walk the rows of all vertices in order. Undirected edges are stored twice,
+		// so only the copy where the source is the smaller end-point is reported.
+		struct iterator : boost::iterator_facade<
+				iterator, EdgeDescriptor,
+				std::forward_iterator_tag, EdgeDescriptor> {
+		public:
+			iterator() = default;
+
+			iterator(VertexDescriptor u, const ConcurrentGraph *g) : u(u), g(g) {
+				if(u < numVertices(*g)) row = outEdges(u, *g).begin();
+				settle();
+			}
+		private:
+			friend class boost::iterator_core_access;
+
+			EdgeDescriptor dereference() const {
+				return *row;
+			}
+
+			bool equal(const iterator &other) const {
+				return u == other.u && row == other.row;
+			}
+
+			void increment() {
+				++row;
+				settle();
+			}
+
+			// Advance to the next reported edge, if the current one is not.
+			void settle() {
+				const std::size_t n = numVertices(*g);
+				while(u < n) {
+					if(row == typename OutEdgeRange::iterator()) {
+						if(++u < n) row = outEdges(u, *g).begin();
+					} else if(isUndirected && (*row).tar < u) {
+						++row;
+					} else {
+						return;
+					}
+				}
+			}
+		private:
+			VertexDescriptor u = 0;
+			typename OutEdgeRange::iterator row;
+			const ConcurrentGraph *g = nullptr;
+		};
+	public:
+		EdgeRange(const ConcurrentGraph *g) : g(g) {}
+
+		iterator begin() const {
+			return iterator(0, g);
+		}
+
+		iterator end() const {
+			return iterator(numVertices(*g), g);
+		}
+	private:
+		const ConcurrentGraph *g;
+	};
+public:
+	// Constructs a graph with n vertices and no edges.
+	explicit ConcurrentGraph(std::size_t n = 0) : n(n) {
+		for(std::size_t s = 0; n != 0 && s <= segmentOf(n - 1); ++s)
+			segments[s].store(new Vertex[segmentSize(s)](), std::memory_order_relaxed);
+	}
+
+	ConcurrentGraph(const ConcurrentGraph&) = delete;
+	ConcurrentGraph &operator=(const ConcurrentGraph&) = delete;
+
+	~ConcurrentGraph() {
+		for(std::size_t s = 0; s != numSegments; ++s) {
+			Vertex *segment = segments[s].load(std::memory_order_relaxed);
+			if(!segment) continue;
+			for(std::size_t i = 0; i != segmentSize(s); ++i) {
+				for(Head &head : segment[i].heads) {
+					for(Block *b = head.load(std::memory_order_relaxed); b;) {
+						Block *next = b->next;
+						Block::destroy(b);
+						b = next;
+					}
+				}
+			}
+			delete[] segment;
+		}
+	}
+
+	// Compacts the graph into CSR format, with the out-edges of each vertex in the order
+	// their addEdge calls claimed their slots, e.g., in the order they were added if one
+	// thread added them. The edges of undirected graphs keep their ids, while those of
+	// directed graphs are numbered by CompressedGraph, by source.
+	// The rows are copied in parallel on pool. No thread may be adding to the graph.
+	CompressedGraph<DirectedCategory> freeze(ThreadPool &pool = defaultThreadPool()) const {
+		struct Frozen {
+			std::vector<std::size_t> offsets, targets, edgeIds, inOffsets, inSources, inEdgeIds;
+		};
+		auto frozen = std::make_shared<Frozen>();
+		const std::size_t numV = numVertices(*this);
+		// Bidirectional: the entry in targets of each edge id
+		std::vector<std::size_t> entryOf(isBidirectional ? numEdges(*this) : 0);
+
+		// The rows of one chain, out or in, into one CSR array, and its ids into another.
+		auto compact = [&](std::size_t chain, std::vector<std::size_t> &offsets,
+		                   std::vector<std::size_t> &vs, auto id) {
+			constexpr std::size_t grain = 1 << 10;
+			offsets.assign(numV + 1, 0);
+			parallelFor(0, numV, [&](std::size_t v) {
+				for(const Block *b = head(v, chain); b; b = b->next) offsets[v + 1] += b->size();
+			}, grain, pool);
+			for(std::size_t v = 0; v != numV; ++v) offsets[v + 1] += offsets[v];
+			vs.resize(offsets[numV]);
+			parallelBlocks(0, numV, grain, [&](std::size_t, std::size_t first, std::size_t last) {
+				std::vector<const Block*> chainBlocks;
+				for(std::size_t v = first; v != last; ++v) {
+					chainBlocks.clear();
+					for(const Block *b = head(v, chain); b; b = b->next) chainBlocks.push_back(b);
+					std::size_t entry = offsets[v];
+					// oldest block first
+					for(auto it = chainBlocks.rbegin(); it != chainBlocks.rend(); ++it) {
+						for(std::uint32_t k = 0; k != (*it)->size(); ++k, ++entry) {
+							const Entry &e = (*it)->entries()[k];
+							vs[entry] = e.v;
+							id(entry, e.id);
+						}
+					}
+				}
+			}, pool);
+		};
+		if constexpr(isUndirected) frozen->edgeIds.resize(2 * numEdges(*this));
+		compact(0, frozen->offsets, frozen->targets, [&](std::size_t entry, std::size_t id) {
+			if constexpr(isUndirected) frozen->edgeIds[entry] = id;
+			if constexpr(isBidirectional) entryOf[id] = entry;
+		});
+		if constexpr(isBidirectional) {
+			frozen->inEdgeIds.resize(numEdges(*this));
+			compact(1, frozen->inOffsets, frozen->inSources, [&](std::size_t entry, std::size_t id) {
+				frozen->inEdgeIds[entry] = entryOf[id];
+			});
+		}
+
+		typename CompressedGraph<DirectedCategory>::Arrays arrays;
+		arrays.numEdges = numEdges(*this);
+		arrays.offsets = frozen->offsets;
+		arrays.targets = frozen->targets;
+		arrays.edgeIds = frozen->edgeIds;
+		arrays.inOffsets = frozen->inOffsets;
+		arrays.inSources = frozen->inSources;
+		arrays.inEdgeIds = frozen->inEdgeIds;
+		return CompressedGraph<DirectedCategory>(std::move(frozen), arrays);
+	}
+private:
+	// Segment s holds the firstSegmentSize << s vertices from firstSegmentSize * (2^s - 1).
+	static std::size_t segmentOf(std::size_t i) {
+		return std::bit_width(i / firstSegmentSize + 1) - 1;
+	}
+
+	static std::size_t segmentSize(std::size_t s) {
+		return firstSegmentSize << s;
+	}
+
+	Vertex &vertex(std::size_t i) const {
+		const std::size_t s = segmentOf(i);
+		Vertex *segment = segments[s].load(std::memory_order_acquire);
+		assert(segment);
+		return segment[i - firstSegmentSize * ((std::size_t(1) << s) - 1)];
+	}
+
+	const Block *head(std::size_t i, std::size_t chain) const {
+		return vertex(i).heads[chain].load(std::memory_order_acquire);
+	}
+
+	// Appends e to the chain starting at head.
+	static void append(Head &head, const Entry &e) {
+		Block *b = head.load(std::memory_order_acquire);
+		for(;;) {
+			if(b) {
+				const std::uint32_t k = b->reserved.fetch_add(1, std::memory_order_relaxed);
+				if(k < b->capacity) {
+					b->entries()[k] = e;
+					return;
+				}
+			}
+			const std::uint32_t capacity = b ? std::min(2 * b->capacity, maxBlockCapacity) : firstBlockCapacity;
+			Block *fresh = Block::create(capacity, b, e);
+			// on failure b is the new head, pushed by another thread, so we try that one
+			if(head.compare_exchange_strong(b, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+				return;
+			Block::destroy(fresh);
+		}
+	}
+private:
+	std::atomic<std::size_t> n, m{0};
+	std::array<std::atomic<Vertex*>, numSegments> segments{};
+public: // Graph
+	friend VertexDescriptor source(const EdgeDescriptor &e, const ConcurrentGraph&) {
+		return e.src;
+	}
+
+	friend VertexDescriptor target(const EdgeDescriptor &e, const ConcurrentGraph&) {
+		return e.tar;
+	}
+public: // VertexList
+	friend std::size_t numVertices(const ConcurrentGraph &g) {
+		return g.n.load(std::memory_order_relaxed);
+	}
+
+	friend VertexRange vertices(const ConcurrentGraph &g) {
+		return VertexRange(numVertices(g));
+	}
+public: // EdgeList
+	friend std::size_t numEdges(const ConcurrentGraph &g) {
+		return g.m.load(std::memory_order_relaxed);
+	}
+
+	friend EdgeRange edges(const ConcurrentGraph &g) {
+		return EdgeRange(&g);
+	}
+public: // Incidence
+	friend OutEdgeRange outEdges(VertexDescriptor v, const ConcurrentGraph &g) {
+		return OutEdgeRange(v, g.head(v, 0));
+	}
+
+	friend std::size_t outDegree(VertexDescriptor v, const ConcurrentGraph &g) {
+		std::size_t degree = 0;
+		for(const Block *b = g.head(v, 0); b; b = b->next) degree += b->size();
+		return degree;
+	}
+public: // Bidirectional
+	friend InEdgeRange inEdges(VertexDescriptor v, const ConcurrentGraph &g)
+		requires isBidirectional {
+		return InEdgeRange(v, g.head(v, 1));
+	}
+
+	friend std::size_t inDegree(VertexDescriptor v, const ConcurrentGraph &g)
+		requires isBidirectional {
+		std::size_t degree = 0;
+		for(const Block *b = g.head(v, 1); b; b = b->next) degree += b->size();
+		return degree;
+	}
+public: // Mutable, thread-safe
+	friend VertexDescriptor addVertex(ConcurrentGraph &g) {
+		const std::size_t i = g.n.fetch_add(1, std::memory_order_relaxed);
+		const std::size_t s = segmentOf(i);
+		assert(s < numSegments);
+		if(!g.segments[s].load(std::memory_order_acquire)) {
+			// the first thread to need the segment installs it, the others drop theirs
+			Vertex *expected = nullptr, *segment = new Vertex[segmentSize(s)]();
+			if(!g.segments[s].compare_exchange_strong(expected, segment, std::memory_order_acq_rel))
+				delete[] segment;
+		}
+		return i;
+	}
+
+	friend EdgeDescriptor addEdge(VertexDescriptor u, VertexDescriptor v, ConcurrentGraph &g) {
+		assert(u < numVertices(g) && v < numVertices(g));
+		const std::size_t id = g.m.fetch_add(1, std::memory_order_relaxed);
+		append(g.vertex(u).heads[0], Entry{v, id});
+		if constexpr(isUndirected) {
+			assert(u != v);
+			append(g.vertex(v).heads[0], Entry{u, id});
+		}
+		if constexpr(isBidirectional) append(g.vertex(v).heads[1], Entry{u, id});
+		return EdgeDescriptor{u, v, id};
+	}
+public: // Other
+	friend std::size_t getIndex(VertexDescriptor v, const ConcurrentGraph&) {
+		return v;
+	}
+};
+
+} // namespace graph
+
+#endif // GRAPH_CONCURRENT_GRAPH_HPP
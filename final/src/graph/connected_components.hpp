@@ -0,0 +1,164 @@
+#ifndef GRAPH_CONNECTED_COMPONENTS_HPP
+#define GRAPH_CONNECTED_COMPONENTS_HPP
+
+#include "concepts.hpp"
+#include "parallel.hpp"
+#include "traits.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace graph {
+namespace detail {
+
+// A union-find structure over [0, n) that threads may use concurrently without locks.
+// Roots are linked by index, the larger root below the smaller one, by compare-and-swap,
+// and finds halve the paths they walk. Parents only ever decrease, so there are no
+// cycles, and the root of a set is always its smallest element.
+class ConcurrentUnionFind {
+public:
+	explicit ConcurrentUnionFind(std::size_t n) : parent(n) {
+		for(std::size_t i = 0; i != n; ++i) parent[i].store(i, std::memory_order_relaxed);
+	}
+
+	std::size_t find(std::size_t x) {
+		while(true) {
+			std::size_t p = parent[x].load(std::memory_order_relaxed);
+			if(p == x) return x;
+			const std::size_t gp = parent[p].load(std::memory_order_relaxed);
+			if(gp == p) return p;
+			// path halving, which fails harmlessly if another thread got there first
+			parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+			x = gp;
+		}
+	}
+
+	void unite(std::size_t a, std::size_t b) {
+		while(true) {
+			a = find(a);
+			b = find(b);
+			if(a == b) return;
+			if(a < b) std::swap(a, b);
+			// a may have been linked by another thread since the find, then retry
+			std::size_t expected = a;
+			if(parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) return;
+		}
+	}
+
+	// Points every element directly to its root.
+	void compress(ThreadPool &pool) {
+		parallelFor(0, parent.size(), [&](std::size_t i) {
+			parent[i].store(find(i), std::memory_order_relaxed);
+		}, 1 << 12, pool);
+	}
+
+	std::size_t size() const {
+		return parent.size();
+	}
+private:
+	std::vector<std::atomic<std::size_t>> parent;
+};
+
+} // namespace detail
+
+// Weakly connected components, in parallel.
+// Sets component[getIndex(v, g)] to the label of the component of v, where the labels
+// are 0, 1, ... in order of the smallest vertex index in each component, and returns
+// the number of components.
+//
+// The edges are united in a lock-free union-find. For graphs modelling IncidenceGraph,
+// the Afforest scheme is used: first each vertex is united with the targets of its
+// first two out-edges, which usually already joins most vertices into one giant
+// component, whose label is then estimated from a sample of the vertices. In an
+// undirected graph every edge is in the out-edges of both its end-points, so the
+// remaining edges of vertices in the giant component need not be looked at, and the
+// other vertices unite their remaining out-edges. Directed graphs unite all remaining
+// out-edges, most of which then stop at the first find.
+// Other graphs are read through edges(g), which the calling thread walks while
+// batches of edges are united by the pool.
+template<typename Graph>
+	requires VertexListGraph<Graph> && IndexedGraph<Graph> && (IncidenceGraph<Graph> || EdgeListGraph<Graph>)
+std::size_t connectedComponents(const Graph &g, std::vector<std::size_t> &component,
+                                ThreadPool &pool = defaultThreadPool()) {
+	using Vertex = typename Traits<Graph>::VertexDescriptor;
+	constexpr std::size_t grain = 1 << 10;
+	const std::size_t n = numVertices(g);
+	detail::ConcurrentUnionFind sets(n);
+
+	if constexpr(IncidenceGraph<Graph>) {
+		constexpr std::size_t neighbourRounds = 2, samples = 1024;
+		std::vector<Vertex> vs(n);
+		for(Vertex v : vertices(g)) vs[getIndex(v, g)] = v;
+
+		for(std::size_t round = 0; round != neighbourRounds; ++round) {
+			parallelFor(0, n, [&](std::size_t u) {
+				const auto out = outEdges(vs[u], g);
+				auto it = out.begin();
+				for(std::size_t k = 0; k != round && it != out.end(); ++k) ++it;
+				if(it != out.end()) sets.unite(u, getIndex(target(*it, g), g));
+			}, grain, pool);
+		}
+		sets.compress(pool);
+
+		// the most frequent root among a fixed pseudo-random sample of the vertices
+		std::size_t giant = n;
+		if(n != 0) {
+			std::unordered_map<std::size_t, std::size_t> count;
+			std::uint64_t x = 0x9E3779B97F4A7C15ull;
+			std::size_t best = 0;
+			for(std::size_t k = 0; k != samples; ++k) {
+				x = x * 6364136223846793005ull + 1442695040888963407ull;
+				const std::size_t root = sets.find(static_cast<std::size_t>(x >> 33) % n);
+				if(++count[root] > best) {
+					best = count[root];
+					giant = root;
+				}
+			}
+		}
+
+		constexpr bool isUndirected = std::is_same_v<typename Traits<Graph>::DirectedCategory, tags::Undirected>;
+		parallelFor(0, n, [&](std::size_t u) {
+			if(isUndirected && sets.find(u) == giant) return;
+			const auto out = outEdges(vs[u], g);
+			auto it = out.begin();
+			for(std::size_t k = 0; k != neighbourRounds && it != out.end(); ++k) ++it;
+			for(; it != out.end(); ++it) sets.unite(u, getIndex(target(*it, g), g));
+		}, grain, pool);
+	} else {
+		constexpr std::size_t batchSize = 1 << 12;
+		TaskGroup group(pool);
+		std::vector<std::pair<std::size_t, std::size_t>> batch;
+		auto flush = [&] {
+			group.run([&sets, b = std::move(batch)] {
+				for(const auto &[u, v] : b) sets.unite(u, v);
+			});
+			batch.clear();
+		};
+		for(const auto &e : edges(g)) {
+			batch.emplace_back(getIndex(source(e, g), g), getIndex(target(e, g), g));
+			if(batch.size() == batchSize) flush();
+		}
+		if(!batch.empty()) flush();
+		group.wait();
+	}
+
+	// the roots are the smallest vertices of their components, so they are labelled in order
+	sets.compress(pool);
+	component.resize(n);
+	std::size_t count = 0;
+	for(std::size_t i = 0; i != n; ++i) {
+		const std::size_t root = sets.find(i);
+		component[i] = root == i ? count++ : component[root];
+	}
+	return count;
+}
+
+} // namespace graph
+
+#endif // GRAPH_CONNECTED_COMPONENTS_HPP
@@ -0,0 +1,60 @@
+#ifndef GRAPH_DEGREE_HISTOGRAM_HPP
+#define GRAPH_DEGREE_HISTOGRAM_HPP
+
+#include "concepts.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <iterator>
+#include <vector>
+
+namespace graph {
+
+// Returns h where h[d] is the number of vertices v of g with degree(v, g) == d,
+// and the last entry of h is non-zero (h is empty for the empty graph).
+// The vertices are split into blocks that are counted concurrently into local
+// histograms, which are summed at the end, so with O(1) degree queries the
+// whole pass is O(n / p + p * maxDegree).
+template<typename Graph, typename Degree>
+	requires VertexListGraph<Graph>
+	      && std::invocable<Degree&, typename Traits<Graph>::VertexDescriptor, const Graph&>
+std::vector<std::size_t> degreeHistogram(const Graph &g, Degree degree, ThreadPool &pool = defaultThreadPool()) {
+	const auto vs = vertices(g);
+	const std::size_t n = numVertices(g);
+	std::vector<std::vector<std::size_t>> local(numBlocks(n, 1 << 12, pool));
+	parallelBlocks(0, n, 1 << 12, [&](std::size_t block, std::size_t first, std::size_t last) {
+		std::vector<std::size_t> &h = local[block];
+		auto it = std::next(vs.begin(), first);
+		for(std::size_t i = first; i != last; ++i, ++it) {
+			const std::size_t d = degree(*it, g);
+			if(d >= h.size()) h.resize(d + 1, 0);
+			++h[d];
+		}
+	}, pool);
+	std::vector<std::size_t> result;
+	for(const auto &h : local) {
+		if(h.size() > result.size()) result.resize(h.size(), 0);
+		std::transform(h.begin(), h.end(), result.begin(), result.begin(),
+		               [](std::size_t a, std::size_t b) { return a + b; });
+	}
+	return result;
+}
+
+// The histogram of out-degrees.
+template<typename Graph>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph>
+std::vector<std::size_t> degreeHistogram(const Graph &g, ThreadPool &pool = defaultThreadPool()) {
+	return degreeHistogram(g, [](auto v, const Graph &g) { return outDegree(v, g); }, pool);
+}
+
+// The histogram of in-degrees.
+template<typename Graph>
+	requires VertexListGraph<Graph> && BidirectionalGraph<Graph>
+std::vector<std::size_t> inDegreeHistogram(const Graph &g, ThreadPool &pool = defaultThreadPool()) {
+	return degreeHistogram(g, [](auto v, const Graph &g) { return inDegree(v, g); }, pool);
+}
+
+} // namespace graph
+
+#endif // GRAPH_DEGREE_HISTOGRAM_HPP
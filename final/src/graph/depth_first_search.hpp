@@ -3,11 +3,28 @@
 
 #include "traits.hpp"
 
+#include <type_traits>
 #include <vector>
 
 namespace graph
 {
 
+	namespace tags
+	{
+
+		// Selects the recursive DFS implementation, one call frame per tree edge.
+		struct DFSRecursive
+		{
+		};
+
+		// Selects the DFS implementation with a heap-allocated stack,
+		// so the depth of the traversal is limited only by memory.
+		struct DFSIterative
+		{
+		};
+
+	} // namespace tags
+
 	struct DFSNullVisitor
 	{
 		template <typename G, typename V>
@@ -76,10 +93,79 @@ namespace graph
 			visitor.finishVertex(u, g);
 		}
 
+		// Same as dfsVisit, with the call stack replaced by an explicit stack.
+		// Each frame holds a vertex and its position in its out-edge range, and
+		// the events are fired in exactly the same order as in dfsVisit.
+		template <typename Graph, typename Visitor>
+		void dfsVisitIterative(const Graph &g, Visitor &visitor, typename Traits<Graph>::VertexDescriptor u,
+							   std::vector<DFSColour> &colour)
+		{
+			using Vertex = typename Traits<Graph>::VertexDescriptor;
+			using OutEdgeIterator = typename Traits<Graph>::OutEdgeRange::iterator;
+
+			struct Frame
+			{
+				Vertex u;
+				OutEdgeIterator it, last;
+			};
+			std::vector<Frame> stack;
+
+			auto enter = [&](Vertex v)
+			{
+				visitor.discoverVertex(v, g);
+				colour[v] = graph::detail::DFSColour::Grey;
+				visitor.startVertex(v, g);
+				auto range = outEdges(v, g);
+				stack.push_back(Frame{v, range.begin(), range.end()});
+			};
+
+			enter(u);
+			while (!stack.empty())
+			{
+				Frame &f = stack.back();
+				if (f.it == f.last)
+				{
+					colour[f.u] = graph::detail::DFSColour::Black;
+					visitor.finishVertex(f.u, g);
+					stack.pop_back();
+					// Returning from the tree edge of the parent.
+					if (!stack.empty())
+					{
+						Frame &parent = stack.back();
+						visitor.finishEdge(*parent.it, g);
+						++parent.it;
+					}
+					continue;
+				}
+				typename Traits<Graph>::EdgeDescriptor e = *f.it;
+				const Vertex v = target(e, g);
+				visitor.examineEdge(e, g);
+				if (colour[v] == graph::detail::DFSColour::White)
+				{
+					visitor.treeEdge(e, g);
+					// f is invalidated by the push, the edge is finished when v is popped.
+					enter(v);
+					continue;
+				}
+				else if (colour[v] == graph::detail::DFSColour::Grey)
+					visitor.backEdge(e, g);
+				else
+				{
+					visitor.forwardOrCrossEdge(e, g);
+				}
+
+				visitor.finishEdge(e, g);
+				++f.it;
+			}
+		}
+
 	} // namespace detail
 
-	template <typename Graph, typename Visitor>
-	void dfs(const Graph &g, Visitor visitor)
+	// Depth-first search over all vertices of g, calling the event points of visitor.
+	// The implementation is selected with tags::DFSRecursive or tags::DFSIterative,
+	// both of which fire the same events in the same order.
+	template <typename Graph, typename Visitor, typename Implementation = tags::DFSRecursive>
+	void dfs(const Graph &g, Visitor visitor, Implementation = Implementation())
 	{
 		std::vector<graph::detail::DFSColour> colour(numVertices(g));
 		for (typename Traits<Graph>::VertexDescriptor u : vertices(g))
@@ -92,7 +178,10 @@ namespace graph
 			if (colour[u] == graph::detail::DFSColour::White)
 			{
 				visitor.startVertex(u, g);
-				dfsVisit(g, visitor, u, colour);
+				if constexpr (std::is_same_v<Implementation, tags::DFSIterative>)
+					graph::detail::dfsVisitIterative(g, visitor, u, colour);
+				else
+					graph::detail::dfsVisit(g, visitor, u, colour);
 			}
 		}
 	}
@@ -0,0 +1,208 @@
+#ifndef GRAPH_DYNAMIC_DAG_HPP
+#define GRAPH_DYNAMIC_DAG_HPP
+
+#include "adjacency_list.hpp"
+#include "edge_index.hpp"
+#include "parallel.hpp"
+#include "properties.hpp"
+#include "tags.hpp"
+#include "topological_sort.hpp"
+#include "traits.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// A DAG that grows one edge at a time while keeping a topological order of its vertices,
+// for dependency graphs that must be ordered after every insertion.
+// Edges that would close a cycle are rejected, and leave the DAG unchanged.
+// The order is maintained with the algorithm of Pearce and Kelly, A Dynamic Topological
+// Sort Algorithm for Directed Acyclic Graphs: an edge x -> y that agrees with the order
+// costs O(1). Otherwise only the vertices between y and x in the order are searched: those
+// reachable from y, which must move after x, and those reaching x, which must move before
+// y. The two sets are then placed into the positions they held, each in its old order,
+// so the cost depends on the part of the order the edge affects, not on the whole graph.
+// Edges that are already in the DAG are not added again, which is common when ingesting
+// dependencies continuously: addEdge returns the existing edge, leaving it unchanged.
+// The graph is an AdjacencyList<tags::Bidirectional>, for the backward search, with a
+// HashEdgeIndex, so that duplicates are found in O(1).
+template<typename VertexPropT = NoProp, typename EdgePropT = NoProp>
+class DynamicDAG {
+	static constexpr bool hasVertexProps = !std::is_same_v<VertexPropT, NoProp>;
+	static constexpr bool hasEdgeProps = !std::is_same_v<EdgePropT, NoProp>;
+public:
+	using Graph = AdjacencyList<tags::Bidirectional, VertexPropT, EdgePropT, HashEdgeIndex<>>;
+	using VertexDescriptor = typename Traits<Graph>::VertexDescriptor;
+	using EdgeDescriptor = typename Traits<Graph>::EdgeDescriptor;
+	using VertexProp = VertexPropT;
+	using EdgeProp = EdgePropT;
+public:
+	// Constructs a DAG with n vertices, ordered by index, and no edges.
+	explicit DynamicDAG(std::size_t n = 0) : g(n), vs(n), ord(n), visited(n, 0) {
+		for(VertexDescriptor v : vertices(g)) vs[getIndex(v, g)] = v;
+		std::iota(ord.begin(), ord.end(), std::size_t(0));
+	}
+
+	// Takes over the DAG g, ordered by parallelTopoSort.
+	// Throws std::invalid_argument if g has a cycle.
+	explicit DynamicDAG(Graph g, ThreadPool &pool = defaultThreadPool())
+		: g(std::move(g)), ord(numVertices(this->g)), visited(numVertices(this->g), 0) {
+		std::vector<std::size_t> level;
+		vs.reserve(numVertices(this->g));
+		if(!parallelTopoSort(this->g, std::back_inserter(vs), level, pool))
+			throw std::invalid_argument("The graph of a DynamicDAG must not have a cycle.");
+		for(std::size_t k = 0; k != vs.size(); ++k) ord[getIndex(vs[k], this->g)] = k;
+	}
+
+	const Graph &graph() const {
+		return g;
+	}
+
+	// The vertices in topological order: every edge goes from a vertex to a later one.
+	const std::vector<VertexDescriptor> &order() const {
+		return vs;
+	}
+
+	// The position of v in order().
+	std::size_t position(VertexDescriptor v) const {
+		return ord[getIndex(v, g)];
+	}
+
+	const VertexProp &operator[](VertexDescriptor v) const requires hasVertexProps {
+		return g[v];
+	}
+
+	VertexProp &operator[](VertexDescriptor v) requires hasVertexProps {
+		return g[v];
+	}
+
+	const EdgeProp &operator[](const EdgeDescriptor &e) const requires hasEdgeProps {
+		return g[e];
+	}
+
+	EdgeProp &operator[](const EdgeDescriptor &e) requires hasEdgeProps {
+		return g[e];
+	}
+private:
+	// Appends the new vertex v to the order.
+	VertexDescriptor pushBack(VertexDescriptor v) {
+		ord.push_back(vs.size());
+		vs.push_back(v);
+		visited.push_back(0);
+		return v;
+	}
+
+	// Makes room for an edge x -> y in the order, or returns false if it would close a cycle.
+	bool makeRoom(VertexDescriptor x, VertexDescriptor y) {
+		const std::size_t xi = getIndex(x, g), yi = getIndex(y, g);
+		if(xi == yi) return false;
+		const std::size_t lowerBound = ord[yi], upperBound = ord[xi];
+		if(lowerBound > upperBound) return true;
+
+		forward.clear();
+		backward.clear();
+		// forward from y through the vertices before x, which must not reach x itself
+		const bool acyclic = search(y, forward, xi, [&](std::size_t wi) { return ord[wi] < upperBound; },
+			[](VertexDescriptor u, const Graph &h) { return outEdges(u, h); },
+			[](const EdgeDescriptor &e, const Graph &h) { return target(e, h); });
+		// backward from x through the vertices after y
+		if(acyclic)
+			search(x, backward, yi, [&](std::size_t wi) { return ord[wi] > lowerBound; },
+				[](VertexDescriptor u, const Graph &h) { return inEdges(u, h); },
+				[](const EdgeDescriptor &e, const Graph &h) { return source(e, h); });
+		for(VertexDescriptor w : forward) visited[getIndex(w, g)] = 0;
+		for(VertexDescriptor w : backward) visited[getIndex(w, g)] = 0;
+		if(!acyclic) return false;
+
+		// The vertices reaching x, then those reachable from y, each in their old order,
+		// take the positions the two sets held together.
+		auto byPosition = [&](VertexDescriptor a, VertexDescriptor b) { return position(a) < position(b); };
+		std::sort(forward.begin(), forward.end(), byPosition);
+		std::sort(backward.begin(), backward.end(), byPosition);
+		slots.clear();
+		for(VertexDescriptor w : backward) slots.push_back(position(w));
+		for(VertexDescriptor w : forward) slots.push_back(position(w));
+		std::sort(slots.begin(), slots.end());
+		std::size_t k = 0;
+		for(const auto *set : {&backward, &forward}) {
+			for(VertexDescriptor w : *set) {
+				ord[getIndex(w, g)] = slots[k];
+				vs[slots[k]] = w;
+				++k;
+			}
+		}
+		return true;
+	}
+
+	// Depth-first search from s along the edges given by incident and next, into the
+	// vertices whose index is allowed by inside, collecting the visited vertices.
+	// Returns false, early, if the vertex with index stop is found.
+	template<typename Inside, typename Incident, typename Next>
+	bool search(VertexDescriptor s, std::vector<VertexDescriptor> &found, std::size_t stop, Inside inside,
+	            Incident incident, Next next) {
+		stack.clear();
+		stack.push_back(s);
+		visited[getIndex(s, g)] = 1;
+		found.push_back(s);
+		while(!stack.empty()) {
+			const VertexDescriptor u = stack.back();
+			stack.pop_back();
+			for(const auto &e : incident(u, g)) {
+				const VertexDescriptor w = next(e, g);
+				const std::size_t wi = getIndex(w, g);
+				if(wi == stop) return false;
+				if(visited[wi] || !inside(wi)) continue;
+				visited[wi] = 1;
+				found.push_back(w);
+				stack.push_back(w);
+			}
+		}
+		return true;
+	}
+private:
+	Graph g;
+	std::vector<VertexDescriptor> vs; // the order
+	std::vector<std::size_t> ord; // the position of each vertex, by index
+	// The scratch space of makeRoom, kept to avoid allocations. visited is all zero between calls.
+	std::vector<char> visited;
+	std::vector<VertexDescriptor> forward, backward, stack;
+	std::vector<std::size_t> slots;
+public:
+	// Adds a vertex, last in the order.
+	friend VertexDescriptor addVertex(DynamicDAG &d) {
+		return d.pushBack(addVertex(d.g));
+	}
+
+	friend VertexDescriptor addVertex(VertexProp vp, DynamicDAG &d) requires hasVertexProps {
+		return d.pushBack(addVertex(std::move(vp), d.g));
+	}
+
+	// Adds the edge u -> v and updates the order, unless the edge would close a cycle,
+	// i.e., u = v or v reaches u, in which case nothing changes and nullopt is returned.
+	// If u -> v is already in the DAG, nothing changes and the existing edge is returned.
+	friend std::optional<EdgeDescriptor> addEdge(VertexDescriptor u, VertexDescriptor v, DynamicDAG &d) {
+		if(const auto e = edge(u, v, d.g)) return e;
+		if(!d.makeRoom(u, v)) return std::nullopt;
+		return addEdge(u, v, d.g);
+	}
+
+	// As above; an existing edge keeps its property.
+	friend std::optional<EdgeDescriptor> addEdge(VertexDescriptor u, VertexDescriptor v, EdgeProp ep,
+	                                             DynamicDAG &d) requires hasEdgeProps {
+		if(const auto e = edge(u, v, d.g)) return e;
+		if(!d.makeRoom(u, v)) return std::nullopt;
+		return addEdge(u, v, std::move(ep), d.g);
+	}
+};
+
+} // namespace graph
+
+#endif // GRAPH_DYNAMIC_DAG_HPP
@@ -0,0 +1,107 @@
+#ifndef GRAPH_EDGE_INDEX_HPP
+#define GRAPH_EDGE_INDEX_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Edge index policy for AdjacencyList: no index is kept.
+// Duplicate edges are only detected by an O(m) assertion in debug builds,
+// and edge(u, v, g) scans the out-edges of u.
+struct NoEdgeIndex {
+	template<typename>
+	using Rebind = NoEdgeIndex;
+};
+
+// Edge index policy for AdjacencyList: an open-addressing hash table
+// with linear probing, mapping (src, tar) to the index of the stored edge.
+// Gives O(1) expected edge(u, v, g) and duplicate rejection in addEdge.
+// The keys and indices are stored as IndexT, which AdjacencyList rebinds to its own
+// index type, so a CompactAdjacencyList keeps 12 bytes per slot rather than 24.
+// An index must be below the maximum of IndexT, which marks an empty slot.
+template<typename IndexT = std::size_t>
+struct HashEdgeIndex {
+	static_assert(std::is_unsigned_v<IndexT>, "The index type must be an unsigned integer type.");
+
+	template<typename OtherIndexT>
+	using Rebind = HashEdgeIndex<OtherIndexT>;
+private:
+	static constexpr IndexT empty = std::numeric_limits<IndexT>::max();
+
+	struct Slot {
+		IndexT src, tar;
+		IndexT idx = empty;
+	};
+public:
+	// Returns the index of the edge (src, tar), if present.
+	std::optional<std::size_t> find(std::size_t src, std::size_t tar) const {
+		if(slots.empty()) return std::nullopt;
+		for(std::size_t i = bucket(src, tar);; i = (i + 1) & mask()) {
+			const Slot &s = slots[i];
+			if(s.idx == empty) return std::nullopt;
+			if(s.src == src && s.tar == tar) return s.idx;
+		}
+	}
+
+	// Maps (src, tar) to idx unless (src, tar) is already present.
+	// Returns the index stored for (src, tar), and whether it was inserted.
+	std::pair<std::size_t, bool> insert(std::size_t src, std::size_t tar, std::size_t idx) {
+		assert(src <= empty && tar <= empty && idx < empty);
+		reserve(count + 1);
+		std::size_t i = bucket(src, tar);
+		for(; slots[i].idx != empty; i = (i + 1) & mask()) {
+			if(slots[i].src == src && slots[i].tar == tar) return {slots[i].idx, false};
+		}
+		slots[i] = Slot{IndexT(src), IndexT(tar), IndexT(idx)};
+		++count;
+		return {idx, true};
+	}
+
+	// Makes room for n keys without rehashing.
+	void reserve(std::size_t n) {
+		// keep the load factor at most 1/2, so probe sequences stay short
+		if(2 * n <= slots.size()) return;
+		std::size_t cap = slots.empty() ? 16 : slots.size();
+		while(2 * n > cap) cap *= 2;
+		std::vector<Slot> old(cap);
+		old.swap(slots);
+		for(const Slot &s : old) {
+			if(s.idx == empty) continue;
+			std::size_t i = bucket(s.src, s.tar);
+			while(slots[i].idx != empty) i = (i + 1) & mask();
+			slots[i] = s;
+		}
+	}
+
+	std::size_t size() const {
+		return count;
+	}
+private:
+	std::size_t mask() const {
+		return slots.size() - 1;
+	}
+
+	// The SplitMix64 finaliser of the combined key.
+	std::size_t bucket(std::size_t src, std::size_t tar) const {
+		std::uint64_t x = static_cast<std::uint64_t>(src) * 0x9E3779B97F4A7C15ull
+		                ^ static_cast<std::uint64_t>(tar);
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		x = x ^ (x >> 31);
+		return static_cast<std::size_t>(x) & mask();
+	}
+private:
+	std::vector<Slot> slots; // the capacity is zero or a power of two
+	std::size_t count = 0;
+};
+
+} // namespace graph
+
+#endif // GRAPH_EDGE_INDEX_HPP
@@ -0,0 +1,211 @@
+#ifndef GRAPH_EDGE_LISTS_HPP
+#define GRAPH_EDGE_LISTS_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// A vector of trivially copyable elements that keeps up to N elements inline, in the
+// object itself, and only allocates for more, from a memory resource that is given to
+// each operation that may allocate instead of being stored. The elements are never
+// freed individually: the resource is expected to release them all at once, e.g., a
+// std::pmr::monotonic_buffer_resource, so destroying a SmallVector does nothing and a
+// SmallVector can only be copied through a resource, by assign.
+template<typename T, std::size_t N>
+class SmallVector {
+	static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+	              "SmallVector copies its elements bytewise.");
+	static_assert(N > 0, "SmallVector needs room for an element inline.");
+public:
+	using value_type = T;
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	SmallVector() {}
+
+	SmallVector(SmallVector &&other) noexcept : count(other.count), cap(other.cap) {
+		if(other.isInline()) std::memcpy(local, other.local, sizeof(local));
+		else heap = other.heap;
+		other.count = 0;
+		other.cap = N;
+	}
+
+	SmallVector &operator=(SmallVector &&other) noexcept {
+		if(this != &other) {
+			this->~SmallVector();
+			new(this) SmallVector(std::move(other));
+		}
+		return *this;
+	}
+
+	SmallVector(const SmallVector&) = delete;
+	SmallVector &operator=(const SmallVector&) = delete;
+
+	std::size_t size() const {
+		return count;
+	}
+
+	bool empty() const {
+		return count == 0;
+	}
+
+	std::size_t capacity() const {
+		return cap;
+	}
+
+	T *data() {
+		return isInline() ? reinterpret_cast<T*>(local) : heap;
+	}
+
+	const T *data() const {
+		return isInline() ? reinterpret_cast<const T*>(local) : heap;
+	}
+
+	iterator begin() { return data(); }
+	iterator end() { return data() + count; }
+	const_iterator begin() const { return data(); }
+	const_iterator end() const { return data() + count; }
+
+	T &operator[](std::size_t i) {
+		return data()[i];
+	}
+
+	const T &operator[](std::size_t i) const {
+		return data()[i];
+	}
+
+	// Makes room for n elements, moving them to a buffer from resource if they do not fit.
+	// The old buffer, unless inline, is returned to the resource.
+	void reserve(std::size_t n, std::pmr::memory_resource &resource) {
+		if(n <= cap) return;
+		assert(n <= std::numeric_limits<std::uint32_t>::max());
+		T *buffer = static_cast<T*>(resource.allocate(n * sizeof(T), alignof(T)));
+		std::memcpy(static_cast<void*>(buffer), data(), count * sizeof(T));
+		if(!isInline()) resource.deallocate(heap, cap * sizeof(T), alignof(T));
+		heap = buffer;
+		cap = static_cast<std::uint32_t>(n);
+	}
+
+	// Appends an element, which must fit, see reserve.
+	template<typename ...Args>
+		requires std::is_constructible_v<T, Args...>
+	void emplace_back(Args &&...args) {
+		assert(count < cap);
+		new(data() + count) T(std::forward<Args>(args)...);
+		++count;
+	}
+
+	// Appends an element, growing by doubling if it does not fit.
+	template<typename ...Args>
+	void emplace_back(std::pmr::memory_resource &resource, Args &&...args) {
+		if(count == cap) reserve(2 * cap, resource);
+		emplace_back(std::forward<Args>(args)...);
+	}
+
+	// Replaces the elements by those of other.
+	void assign(const SmallVector &other, std::pmr::memory_resource &resource) {
+		count = 0;
+		reserve(other.count, resource);
+		std::memcpy(static_cast<void*>(data()), other.data(), other.count * sizeof(T));
+		count = other.count;
+	}
+private:
+	bool isInline() const {
+		return cap == N;
+	}
+private:
+	std::uint32_t count = 0, cap = N; // exactly N while the elements are inline
+	union {
+		T *heap;
+		alignas(T) unsigned char local[N * sizeof(T)];
+	};
+};
+
+// Edge list policy for AdjacencyList: each list of incident edges is a std::vector,
+// which allocates on its own, once per list, and is freed on its own.
+struct VectorEdgeLists {
+	template<typename T>
+	using List = std::vector<T>;
+
+	// Whether lists may grow concurrently, as long as each list is grown by one thread.
+	static constexpr bool concurrentGrowth = true;
+
+	template<typename T>
+	void reserve(List<T> &l, std::size_t n) {
+		l.reserve(n);
+	}
+
+	template<typename T, typename ...Args>
+	void emplaceBack(List<T> &l, Args &&...args) {
+		l.emplace_back(std::forward<Args>(args)...);
+	}
+
+	template<typename T>
+	List<T> copy(const List<T> &l) {
+		return l;
+	}
+};
+
+// Edge list policy for AdjacencyList: each list of incident edges keeps its first
+// InlineEdges edges inline in the vertex, and only longer lists take memory from an
+// arena owned by the graph, a std::pmr::monotonic_buffer_resource that hands out
+// consecutive pieces of large blocks. So vertices of low degree allocate nothing,
+// building a graph calls malloc for a few growing blocks only, and destroying it
+// releases the blocks, without visiting the lists.
+// A copy of the graph gets its own arena. The arena is not thread-safe, so lists that
+// grow concurrently are reserved up front.
+template<std::size_t InlineEdges = 4>
+class ArenaEdgeLists {
+public:
+	template<typename T>
+	using List = SmallVector<T, InlineEdges>;
+
+	static constexpr bool concurrentGrowth = false;
+
+	ArenaEdgeLists() = default;
+
+	// The lists of a copy are copied into an arena of its own, see copy.
+	ArenaEdgeLists(const ArenaEdgeLists&) {}
+
+	ArenaEdgeLists(ArenaEdgeLists&&) noexcept = default;
+	ArenaEdgeLists &operator=(ArenaEdgeLists&&) noexcept = default;
+
+	template<typename T>
+	void reserve(List<T> &l, std::size_t n) {
+		l.reserve(n, resource());
+	}
+
+	template<typename T, typename ...Args>
+	void emplaceBack(List<T> &l, Args &&...args) {
+		l.emplace_back(resource(), std::forward<Args>(args)...);
+	}
+
+	template<typename T>
+	List<T> copy(const List<T> &l) {
+		List<T> result;
+		result.assign(l, resource());
+		return result;
+	}
+private:
+	// Created on first use, so graphs without long lists, and moved-from ones, have none.
+	std::pmr::memory_resource &resource() {
+		if(!arena) arena = std::make_unique<std::pmr::monotonic_buffer_resource>(initialBlockSize);
+		return *arena;
+	}
+private:
+	static constexpr std::size_t initialBlockSize = 1 << 16;
+	std::unique_ptr<std::pmr::monotonic_buffer_resource> arena;
+};
+
+} // namespace graph
+
+#endif // GRAPH_EDGE_LISTS_HPP
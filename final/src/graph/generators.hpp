@@ -0,0 +1,405 @@
+#ifndef GRAPH_GENERATORS_HPP
+#define GRAPH_GENERATORS_HPP
+
+#include "concepts.hpp"
+#include "edge_index.hpp"
+#include "io.hpp"
+#include "parallel.hpp"
+#include "tags.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Seeded generators of synthetic graphs, as edges between vertex indices.
+// The edges are sampled in fixed chunks, each with its own random stream derived from
+// the seed and the chunk number, and the chunks run in parallel, so the result depends
+// only on the arguments and not on the number of threads.
+// A generator hands its chunks in order to a consumer, a few per thread at a time, so
+// the edges can go straight into a graph: in bulk through buildGraph, or edge by edge to
+// a MutableGraph through streamGenerated, which both drop the duplicates the chunks may hold.
+// The functions returning edge lists collect the chunks into a simple, i.e., without
+// self-loops and duplicates, and sorted list, which can be given to any graph as well.
+namespace graph {
+namespace detail {
+
+inline std::uint64_t mix64(std::uint64_t x) {
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+	return x ^ (x >> 31);
+}
+
+// A SplitMix64 stream, one per seed and stream number.
+struct Random {
+	std::uint64_t state;
+
+	Random(std::uint64_t seed, std::uint64_t stream) : state(mix64(seed ^ mix64(stream + 0x9E3779B97F4A7C15ull))) {}
+
+	std::uint64_t next() {
+		state += 0x9E3779B97F4A7C15ull;
+		return mix64(state);
+	}
+
+	// Uniform in [0, 1).
+	double uniform() {
+		return double(next() >> 11) * 0x1p-53;
+	}
+
+	// Uniform in [0, n), for n > 0, up to a bias of n / 2^64.
+	std::uint64_t below(std::uint64_t n) {
+		return next() % n;
+	}
+};
+
+// A pseudo-random permutation of [0, n) given by the seed, that maps each element in O(1)
+// expected time without a table: a bijection of the smallest power of two range holding
+// [0, n), made of odd multiplications and xor-shifts, walked until it lands below n.
+class Scramble {
+public:
+	Scramble(std::size_t n, std::uint64_t seed) : n(n) {
+		while(bits < 64 && (std::uint64_t(1) << bits) < n) ++bits;
+		mask = bits == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1;
+		Random r(seed, 0);
+		k1 = r.next() | 1;
+		k2 = r.next();
+		k3 = r.next() | 1;
+	}
+
+	std::size_t operator()(std::size_t x) const {
+		do x = step(x); while(x >= n);
+		return x;
+	}
+private:
+	std::uint64_t step(std::uint64_t x) const {
+		const unsigned shift = bits / 2 + 1;
+		x = (x * k1) & mask;
+		x ^= x >> shift;
+		x = (x + k2) & mask;
+		x = (x * k3) & mask;
+		return x ^ (x >> shift);
+	}
+private:
+	std::size_t n;
+	unsigned bits = 0;
+	std::uint64_t mask, k1, k2, k3;
+};
+
+using GeneratedEdges = std::vector<std::pair<std::size_t, std::size_t>>;
+
+// Fills the chunks 0, ..., numChunks - 1 by fill(c, edges), in parallel rounds of a few
+// per thread, and after each round hands them in order to consume(edges) on the calling
+// thread. Only the chunks of one round are held at a time.
+template<typename Fill, typename Consume>
+void forEachChunk(std::size_t numChunks, Fill fill, Consume &consume, ThreadPool &pool) {
+	std::vector<GeneratedEdges> round(std::min(numChunks, numBlocks(numChunks, 1, pool)));
+	for(std::size_t first = 0; first < numChunks; first += round.size()) {
+		const std::size_t size = std::min(round.size(), numChunks - first);
+		parallelFor(0, size, [&](std::size_t k) {
+			round[k].clear();
+			fill(first + k, round[k]);
+		}, 1, pool);
+		for(std::size_t k = 0; k != size; ++k) consume(std::as_const(round[k]));
+	}
+}
+
+// Draws count edges by sample(random), a chunk of them per random stream, dropping
+// self-loops, and hands the chunks to consume.
+template<typename Sample, typename Consume>
+void sampleEdges(std::size_t count, std::uint64_t seed, Sample sample, Consume &consume, ThreadPool &pool) {
+	constexpr std::size_t chunk = 1 << 16;
+	forEachChunk((count + chunk - 1) / chunk, [&](std::size_t c, GeneratedEdges &edges) {
+		Random random(seed, c);
+		const std::size_t size = std::min(chunk, count - c * chunk);
+		edges.reserve(size);
+		for(std::size_t k = 0; k != size; ++k) {
+			const auto [u, v] = sample(random);
+			if(u != v) edges.emplace_back(u, v);
+		}
+	}, consume, pool);
+}
+
+// Sorts the edges over [0, n) and removes self-loops and duplicates, where for undirected
+// graphs (u, v) and (v, u) are the same edge, which is kept as (min, max).
+// The edges are bucketed by source like the rows of a CSR, then each bucket is sorted and
+// written back over the given edges.
+inline GeneratedEdges simplify(std::size_t n, GeneratedEdges edges, bool undirected, ThreadPool &pool) {
+	constexpr std::size_t grain = 1 << 14;
+	auto canonical = [undirected](std::pair<std::size_t, std::size_t> e) {
+		if(undirected && e.first > e.second) std::swap(e.first, e.second);
+		return e;
+	};
+	std::vector<std::atomic<std::size_t>> next(n);
+	parallelFor(0, edges.size(), [&](std::size_t k) {
+		next[canonical(edges[k]).first].fetch_add(1, std::memory_order_relaxed);
+	}, grain, pool);
+	std::vector<std::size_t> offset(n + 1, 0);
+	for(std::size_t u = 0; u != n; ++u) {
+		offset[u + 1] = offset[u] + next[u].load(std::memory_order_relaxed);
+		next[u].store(offset[u], std::memory_order_relaxed);
+	}
+	std::vector<std::size_t> targets(edges.size());
+	parallelFor(0, edges.size(), [&](std::size_t k) {
+		const auto [u, v] = canonical(edges[k]);
+		targets[next[u].fetch_add(1, std::memory_order_relaxed)] = v;
+	}, grain, pool);
+
+	std::vector<std::size_t> kept(n + 1, 0);
+	parallelFor(0, n, [&](std::size_t u) {
+		const auto first = targets.begin() + offset[u], last = targets.begin() + offset[u + 1];
+		std::sort(first, last);
+		auto end = std::unique(first, last);
+		end = std::remove(first, end, u);
+		kept[u + 1] = end - first;
+	}, 1 << 10, pool);
+	for(std::size_t u = 0; u != n; ++u) kept[u + 1] += kept[u];
+	edges.resize(kept[n]);
+	parallelFor(0, n, [&](std::size_t u) {
+		for(std::size_t k = 0; k != kept[u + 1] - kept[u]; ++k)
+			edges[kept[u] + k] = {u, targets[offset[u] + k]};
+	}, 1 << 10, pool);
+	return edges;
+}
+
+// The chunks of a generator, concatenated in order.
+template<typename Generator>
+GeneratedEdges concatenate(const Generator &gen, ThreadPool &pool) {
+	GeneratedEdges edges;
+	edges.reserve(gen.maxEdges());
+	gen.generate([&](const GeneratedEdges &chunk) { edges.insert(edges.end(), chunk.begin(), chunk.end()); }, pool);
+	return edges;
+}
+
+// Whether a graph skips the duplicates among the edges it is given, through an edge index.
+template<typename Graph>
+concept IndexesEdges = !std::is_same_v<typename Graph::EdgeIndex, NoEdgeIndex>;
+
+} // namespace detail
+
+// A generator of edges between the vertex indices [0, gen.numVertices()), at most
+// gen.maxEdges() of them, that gen.generate(consume, pool) hands in chunks to consume,
+// in an order given by the generator alone. The edges have no self-loops, but the
+// chunks may hold duplicates.
+template<typename G>
+concept EdgeGenerator = requires(const G &gen, void (&consume)(const std::vector<std::pair<std::size_t, std::size_t>>&),
+                                 ThreadPool &pool) {
+	{ gen.numVertices() } -> std::convertible_to<std::size_t>;
+	{ gen.maxEdges() } -> std::convertible_to<std::size_t>;
+	gen.generate(consume, pool);
+};
+
+// The probabilities of the top-left, top-right and bottom-left quadrants of R-MAT,
+// where the bottom-right one gets the rest, and whether the vertices are relabelled
+// by a seeded permutation, so the vertices of high degree are not the low indices.
+// The defaults are those of the Graph500 Kronecker generator.
+struct RMatParameters {
+	double a = 0.57, b = 0.19, c = 0.19;
+	bool scramble = true;
+};
+
+// An R-MAT, or stochastic Kronecker, graph on 2^scale vertices with a skewed, power-law
+// like degree distribution: each of numEdges edges picks one quadrant of the adjacency
+// matrix per bit of its end-points. The draws repeat some edges, so once the duplicates
+// are removed there are somewhat fewer edges than drawn.
+struct RMatGenerator {
+	std::size_t scale, numEdges;
+	std::uint64_t seed;
+	RMatParameters p = RMatParameters();
+
+	std::size_t numVertices() const { return std::size_t(1) << scale; }
+	std::size_t maxEdges() const { return numEdges; }
+
+	template<typename Consume>
+	void generate(Consume consume, ThreadPool &pool = defaultThreadPool()) const {
+		assert(scale < 64 && p.a + p.b + p.c <= 1);
+		const detail::Scramble relabel(numVertices(), seed ^ 0x5CA1AB1Eull);
+		detail::sampleEdges(numEdges, seed, [&](detail::Random &random) {
+			std::size_t u = 0, v = 0;
+			for(std::size_t bit = 0; bit != scale; ++bit) {
+				const double r = random.uniform();
+				u = 2 * u + (r >= p.a + p.b);
+				v = 2 * v + ((r >= p.a && r < p.a + p.b) || r >= p.a + p.b + p.c);
+			}
+			return p.scramble ? std::make_pair(relabel(u), relabel(v)) : std::make_pair(u, v);
+		}, consume, pool);
+	}
+};
+
+// A uniform random graph on n vertices, the G(n, m) model of Erdős and Rényi with
+// numEdges directed edges drawn independently, some of which are self-loops, which are
+// dropped, or duplicates. For m much smaller than n^2 only few are.
+struct ErdosRenyiGenerator {
+	std::size_t n, numEdges;
+	std::uint64_t seed;
+
+	std::size_t numVertices() const { return n; }
+	std::size_t maxEdges() const { return n < 2 ? 0 : numEdges; }
+
+	template<typename Consume>
+	void generate(Consume consume, ThreadPool &pool = defaultThreadPool()) const {
+		if(n < 2) return;
+		detail::sampleEdges(numEdges, seed, [n = n](detail::Random &random) {
+			const std::size_t u = random.below(n);
+			return std::make_pair(u, std::size_t(random.below(n)));
+		}, consume, pool);
+	}
+};
+
+// A rows by cols grid, vertex r * cols + c in row r and column c, with an edge to the
+// right and one down from each vertex, i.e., from the lower index to the higher one.
+// Each edge is kept with the given probability, so with keep below 1 the grid looks
+// like a road network: planar, of low degree and large diameter, with dead ends.
+// The edges come sorted and without duplicates.
+// For a graph with edges in both directions, use an undirected graph.
+struct GridGenerator {
+	std::size_t rows, cols;
+	std::uint64_t seed;
+	double keep = 1;
+
+	std::size_t numVertices() const { return rows * cols; }
+	std::size_t maxEdges() const { return 2 * numVertices(); }
+
+	template<typename Consume>
+	void generate(Consume consume, ThreadPool &pool = defaultThreadPool()) const {
+		constexpr std::size_t chunk = 1 << 14;
+		const std::size_t n = numVertices();
+		// each edge decides by its own hash, so the chunks need no streams
+		auto kept = [&](std::size_t slot) {
+			return keep >= 1 || double(detail::mix64(seed ^ detail::mix64(slot)) >> 11) * 0x1p-53 < keep;
+		};
+		detail::forEachChunk((n + chunk - 1) / chunk, [&](std::size_t c, detail::GeneratedEdges &edges) {
+			for(std::size_t u = c * chunk; u != std::min(n, (c + 1) * chunk); ++u) {
+				if((u + 1) % cols != 0 && kept(2 * u)) edges.emplace_back(u, u + 1);
+				if(u + cols < n && kept(2 * u + 1)) edges.emplace_back(u, u + cols);
+			}
+		}, consume, pool);
+	}
+};
+
+// A random DAG on n vertices with numEdges edges drawn uniformly among the pairs, less
+// self-loops, and directed along a random topological order, such that the vertex
+// indices are not themselves a topological order. Some edges may be drawn twice.
+struct RandomDagGenerator {
+	std::size_t n, numEdges;
+	std::uint64_t seed;
+
+	std::size_t numVertices() const { return n; }
+	std::size_t maxEdges() const { return n < 2 ? 0 : numEdges; }
+
+	template<typename Consume>
+	void generate(Consume consume, ThreadPool &pool = defaultThreadPool()) const {
+		if(n < 2) return;
+		const detail::Scramble order(n, seed ^ 0xDA6ull);
+		detail::sampleEdges(numEdges, seed, [&](detail::Random &random) {
+			std::size_t u = random.below(n), v = random.below(n);
+			if(u > v) std::swap(u, v);
+			return std::make_pair(order(u), order(v));
+		}, consume, pool);
+	}
+};
+
+// The edges of RMatGenerator, sorted and without duplicates.
+inline std::vector<std::pair<std::size_t, std::size_t>>
+rmatEdges(std::size_t scale, std::size_t numEdges, std::uint64_t seed, RMatParameters p = RMatParameters(),
+          ThreadPool &pool = defaultThreadPool()) {
+	const RMatGenerator gen{scale, numEdges, seed, p};
+	return detail::simplify(gen.numVertices(), detail::concatenate(gen, pool), false, pool);
+}
+
+// The edges of ErdosRenyiGenerator, sorted and without duplicates.
+inline std::vector<std::pair<std::size_t, std::size_t>>
+erdosRenyiEdges(std::size_t n, std::size_t numEdges, std::uint64_t seed, ThreadPool &pool = defaultThreadPool()) {
+	const ErdosRenyiGenerator gen{n, numEdges, seed};
+	return detail::simplify(n, detail::concatenate(gen, pool), false, pool);
+}
+
+// The edges of GridGenerator, which are sorted and without duplicates as generated.
+inline std::vector<std::pair<std::size_t, std::size_t>>
+gridEdges(std::size_t rows, std::size_t cols, std::uint64_t seed, double keep = 1,
+          ThreadPool &pool = defaultThreadPool()) {
+	return detail::concatenate(GridGenerator{rows, cols, seed, keep}, pool);
+}
+
+// The edges of RandomDagGenerator, sorted and without duplicates.
+inline std::vector<std::pair<std::size_t, std::size_t>>
+randomDagEdges(std::size_t n, std::size_t numEdges, std::uint64_t seed, ThreadPool &pool = defaultThreadPool()) {
+	const RandomDagGenerator gen{n, numEdges, seed};
+	return detail::simplify(n, detail::concatenate(gen, pool), false, pool);
+}
+
+// Constructs a Graph with n vertices and the generated edges through its bulk construction
+// path, see loadDimacs. For undirected graphs, edges given in both directions are added once.
+template<typename Graph>
+Graph buildGraph(std::size_t n, const std::vector<std::pair<std::size_t, std::size_t>> &edges,
+                 ThreadPool &pool = defaultThreadPool()) {
+	if constexpr(std::is_same_v<typename Traits<Graph>::DirectedCategory, tags::Undirected>)
+		return detail::buildFromEdges<Graph>(n, detail::simplify(n, edges, true, pool), pool);
+	else
+		return detail::buildFromEdges<Graph>(n, edges, pool);
+}
+
+// Constructs a Graph with the vertices and edges of gen, once each, in bulk.
+// A graph with an edge index and addEdges, such as an AdjacencyList with HashEdgeIndex, is
+// given each chunk as it is generated, and its index skips the duplicates. Any other graph
+// is constructed through buildFromEdges, see loadDimacs, from the chunks collected into one
+// list, whose duplicates are removed in place by sorting the targets of each source.
+template<typename Graph, typename Generator>
+	requires EdgeGenerator<Generator>
+Graph buildGraph(const Generator &gen, ThreadPool &pool = defaultThreadPool()) {
+	using Iter = detail::GeneratedEdges::const_iterator;
+	const std::size_t n = gen.numVertices();
+	if constexpr(detail::IndexesEdges<Graph> && requires(Graph &h, Iter it) { addEdges(it, it, h, pool); }) {
+		Graph g(n);
+		gen.generate([&](const detail::GeneratedEdges &chunk) { addEdges(chunk.begin(), chunk.end(), g, pool); }, pool);
+		return g;
+	} else {
+		constexpr bool isUndirected = std::is_same_v<typename Traits<Graph>::DirectedCategory, tags::Undirected>;
+		return detail::buildFromEdges<Graph>(n, detail::simplify(n, detail::concatenate(gen, pool), isUndirected, pool),
+		                                     pool);
+	}
+}
+
+// Adds the generated edges to g one by one through addEdge, first adding vertices until
+// g has n of them. The edge (i, j) is added between the vertices of index i and j.
+// For undirected graphs, edges given in both directions are added once.
+template<typename Graph>
+	requires MutableGraph<Graph> && VertexListGraph<Graph> && IndexedGraph<Graph>
+void streamEdges(std::size_t n, const std::vector<std::pair<std::size_t, std::size_t>> &edges, Graph &g,
+                 ThreadPool &pool = defaultThreadPool()) {
+	while(numVertices(g) < n) addVertex(g);
+	std::vector<typename Traits<Graph>::VertexDescriptor> vs(numVertices(g));
+	for(auto v : vertices(g)) vs[getIndex(v, g)] = v;
+	auto add = [&](const auto &el) {
+		for(const auto &[u, v] : el) addEdge(vs[u], vs[v], g);
+	};
+	if constexpr(std::is_same_v<typename Traits<Graph>::DirectedCategory, tags::Undirected>)
+		add(detail::simplify(n, edges, true, pool));
+	else
+		add(edges);
+}
+
+// Adds the edges of gen to g one by one through addEdge as each chunk is generated, first
+// adding vertices until g has gen.numVertices() of them. The edge (i, j) is added between
+// the vertices of index i and j, unless edge finds it in g already, which takes O(1) with
+// an edge index, and otherwise a scan of the out-edges of the vertex of index i.
+template<typename Graph, typename Generator>
+	requires EdgeGenerator<Generator> && MutableGraph<Graph> && VertexListGraph<Graph> && IndexedGraph<Graph>
+	      && requires(const Graph &g, typename Traits<Graph>::VertexDescriptor v) { edge(v, v, g); }
+void streamGenerated(const Generator &gen, Graph &g, ThreadPool &pool = defaultThreadPool()) {
+	while(numVertices(g) < gen.numVertices()) addVertex(g);
+	std::vector<typename Traits<Graph>::VertexDescriptor> vs(numVertices(g));
+	for(auto v : vertices(g)) vs[getIndex(v, g)] = v;
+	gen.generate([&](const detail::GeneratedEdges &chunk) {
+		for(const auto &[u, v] : chunk)
+			if(!edge(vs[u], vs[v], g)) addEdge(vs[u], vs[v], g);
+	}, pool);
+}
+
+} // namespace graph
+
+#endif // GRAPH_GENERATORS_HPP
@@ -1,9 +1,28 @@
 #ifndef GRAPH_IO_HPP
 #define GRAPH_IO_HPP
 
+#include "compressed_graph.hpp"
+#include "mapped_file.hpp"
+#include "parallel.hpp"
+#include "properties.hpp"
 #include "traits.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace graph {
 
@@ -45,6 +64,434 @@ Graph loadDimacs(std::istream &s) {
 	return g;
 }
 
+namespace detail {
+
+// A hand-written scanner over the characters [pos, last),
+// following the token rules of std::istream >> for the DIMACS format.
+struct DimacsScanner {
+	const char *pos, *last;
+public:
+	static bool isSpace(char c) {
+		return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+	}
+
+	void skipSpace() {
+		while(pos != last && isSpace(*pos)) ++pos;
+	}
+
+	bool atEnd() {
+		skipSpace();
+		return pos == last;
+	}
+
+	// Reads a single non-space character.
+	bool readChar(char &c) {
+		skipSpace();
+		if(pos == last) return false;
+		c = *pos++;
+		return true;
+	}
+
+	// Reads a maximal sequence of non-space characters.
+	bool readWord(std::string_view &w) {
+		skipSpace();
+		const char *first = pos;
+		while(pos != last && !isSpace(*pos)) ++pos;
+		w = std::string_view(first, pos - first);
+		return first != pos;
+	}
+
+	// Reads an unsigned decimal integer, failing on overflow.
+	bool readNumber(std::size_t &x) {
+		skipSpace();
+		if(pos == last || *pos < '0' || *pos > '9') return false;
+		std::size_t v = 0;
+		for(; pos != last && *pos >= '0' && *pos <= '9'; ++pos) {
+			const std::size_t d = *pos - '0';
+			if(v > (std::numeric_limits<std::size_t>::max() - d) / 10) return false;
+			v = v * 10 + d;
+		}
+		x = v;
+		return true;
+	}
+};
+
+// The edges parsed from one line-aligned block of a DIMACS file, 0-indexed,
+// and the first error in the block, which is for the edge after the last parsed one.
+struct DimacsBlock {
+	enum struct Error { None, ExpectedE, ExpectedSourceTarget, SourceBounds, TargetBounds };
+public:
+	std::vector<std::pair<std::size_t, std::size_t>> edges;
+	Error error = Error::None;
+	std::size_t value = 0; // the out-of-bounds vertex
+};
+
+// At most maxEdges edges are kept, the number the header announces.
+inline DimacsBlock parseDimacsBlock(const char *first, const char *last, std::size_t n, std::size_t maxEdges) {
+	DimacsBlock block;
+	// one edge per line at most, so the reservation is bounded by the text, not the header
+	const std::size_t lines = std::count(first, last, '\n') + 1;
+	block.edges.reserve(std::min(lines, maxEdges));
+	DimacsScanner s{first, last};
+	auto fail = [&](DimacsBlock::Error error, std::size_t value = 0) {
+		block.error = error;
+		block.value = value;
+		return block;
+	};
+	while(block.edges.size() != maxEdges && !s.atEnd()) {
+		char cmd;
+		if(!s.readChar(cmd) || cmd != 'e') return fail(DimacsBlock::Error::ExpectedE);
+		std::size_t src, tar;
+		if(!s.readNumber(src) || !s.readNumber(tar)) return fail(DimacsBlock::Error::ExpectedSourceTarget);
+		if(src == 0 || src > n) return fail(DimacsBlock::Error::SourceBounds, src);
+		if(tar == 0 || tar > n) return fail(DimacsBlock::Error::TargetBounds, tar);
+		block.edges.emplace_back(src - 1, tar - 1);
+	}
+	return block;
+}
+
+// Constructs a Graph with n vertices and the given edges, a forward range of pairs, in bulk:
+// through an edge-list constructor when there is one, given the pool if it takes one, otherwise
+// by addEdge, after reserving capacity through reserveEdges if available.
+template<typename Graph, typename Edges>
+Graph buildFromEdges(std::size_t n, const Edges &edges, ThreadPool &pool) {
+	using Iter = std::ranges::iterator_t<const Edges>;
+	if constexpr(std::is_constructible_v<Graph, std::size_t, Iter, Iter, ThreadPool&>) {
+		return Graph(n, std::ranges::begin(edges), std::ranges::end(edges), pool);
+	} else if constexpr(std::is_constructible_v<Graph, std::size_t, Iter, Iter>) {
+		return Graph(n, std::ranges::begin(edges), std::ranges::end(edges));
+	} else {
+		Graph g(n);
+		if constexpr(requires(Graph &h) { reserveEdges(std::size_t(0), h); })
+			reserveEdges(std::ranges::distance(edges), g);
+		for(const auto &[src, tar] : edges)
+			addEdge(src, tar, g);
+		return g;
+	}
+}
+
+} // namespace detail
+
+// Same as loadDimacs, but parses the DIMACS text in [first, last) directly.
+// After the header, the text is split into line-aligned blocks of at least
+// minBlockSize bytes that are parsed concurrently, so every edge line must be
+// on a line of its own. The reported errors are the same as for loadDimacs.
+template<typename Graph>
+Graph loadDimacs(const char *first, const char *last, std::size_t minBlockSize = 1 << 20,
+                 ThreadPool &pool = defaultThreadPool()) {
+	auto error = [](auto &&msg) {
+		throw std::runtime_error(std::string("Parsing error: ") + msg);
+	};
+	detail::DimacsScanner s{first, last};
+	char cmd;
+	if(!s.readChar(cmd) || cmd != 'p') error("Expected 'p'.");
+	std::string_view edgeKeyword;
+	if(!s.readWord(edgeKeyword) || edgeKeyword != "edge") error("Expected 'edge'.");
+	std::size_t n;
+	if(!s.readNumber(n)) error("Expected number of vertices.");
+	std::size_t m;
+	if(!s.readNumber(m)) error("Expected number of edges.");
+
+	// A block starts at the beginning of the line containing its first byte, or the next one.
+	const char *body = s.pos;
+	const std::size_t size = last - body;
+	auto alignedStart = [&](std::size_t offset) {
+		const char *p = body + offset;
+		if(offset == 0) return p;
+		while(p != last && p[-1] != '\n') ++p;
+		return p;
+	};
+	std::vector<detail::DimacsBlock> blocks(numBlocks(size, minBlockSize, pool));
+	parallelBlocks(0, size, minBlockSize, [&](std::size_t b, std::size_t bFirst, std::size_t bLast) {
+		blocks[b] = detail::parseDimacsBlock(alignedStart(bFirst), alignedStart(bLast), n, m);
+	}, pool);
+
+	// Take the first m edges from the blocks, without copying them, reporting the first
+	// error among them. m is only trusted as far as there are edges in the text.
+	std::vector<std::vector<std::pair<std::size_t, std::size_t>>> parts;
+	std::size_t count = 0;
+	for(auto &block : blocks) {
+		const std::size_t take = std::min(block.edges.size(), m - count);
+		block.edges.resize(take);
+		count += take;
+		parts.push_back(std::move(block.edges));
+		if(count == m) break;
+		const std::string i = std::to_string(count + 1);
+		switch(block.error) {
+		case detail::DimacsBlock::Error::None:
+			break;
+		case detail::DimacsBlock::Error::ExpectedE:
+			error("Expected 'e' for edge " + i + ".");
+			break;
+		case detail::DimacsBlock::Error::ExpectedSourceTarget:
+			error("Expected source and target for edge " + i + ".");
+			break;
+		case detail::DimacsBlock::Error::SourceBounds:
+			error("Source " + std::to_string(block.value) + " for edge " + i + " is out of bounds.");
+			break;
+		case detail::DimacsBlock::Error::TargetBounds:
+			error("Target " + std::to_string(block.value) + " for edge " + i + " is out of bounds.");
+			break;
+		}
+	}
+	if(count < m) error("Expected 'e' for edge " + std::to_string(count + 1) + ".");
+	blocks.clear();
+	return detail::buildFromEdges<Graph>(n, std::views::join(parts), pool);
+}
+
+// Same as loadDimacs, but reads the file at the given path through a memory mapping.
+template<typename Graph>
+Graph loadDimacsFile(const std::string &path, std::size_t minBlockSize = 1 << 20,
+                     ThreadPool &pool = defaultThreadPool()) {
+	detail::MappedFile file(path);
+	file.adviseSequential();
+	return loadDimacs<Graph>(file.data(), file.data() + file.size(), minBlockSize, pool);
+}
+
+// The version of the binary graph format written by saveBinary.
+inline constexpr std::uint32_t binaryFormatVersion = 1;
+
+namespace detail {
+
+// The header at the start of a binary graph file.
+// It is followed by the arrays of a CompressedGraph, each starting at a multiple
+// of 64 bytes, in the order of BinaryLayout. All integers are std::size_t in the
+// byte order of the machine that wrote the file, which is checked on opening.
+struct BinaryHeader {
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t byteOrder; // byteOrderMark as written by the saving machine
+	std::uint32_t category;  // 0 for undirected, 1 for directed, 2 for bidirectional
+	std::uint32_t indexSize; // sizeof(std::size_t)
+	std::uint64_t vertexPropSize, edgePropSize; // 0 for NoProp
+	std::uint64_t n, m, entries, inEntries;
+};
+
+inline constexpr char binaryMagic[8] = {'D', 'M', '8', '5', '2', 'G', 'R', '\0'};
+inline constexpr std::uint32_t byteOrderMark = 0x01020304;
+
+template<typename DirectedCategory>
+constexpr std::uint32_t binaryCategory() {
+	if constexpr(std::is_same_v<DirectedCategory, tags::Undirected>) return 0;
+	else if constexpr(std::is_same_v<DirectedCategory, tags::Bidirectional>) return 2;
+	else return 1;
+}
+
+// The byte offsets of the sections of a binary graph file, and its total size.
+// The sizes come from a header that may be corrupt, so valid is false if any of them
+// overflows.
+struct BinaryLayout {
+	enum Section {
+		Offsets, Targets, EdgeIds, InOffsets, InSources, InEdgeIds, VertexProps, EdgeProps, NumSections
+	};
+public:
+	explicit BinaryLayout(const BinaryHeader &h) {
+		const std::uint64_t idx = sizeof(std::size_t);
+		auto times = [&](std::uint64_t a, std::uint64_t b) {
+			std::uint64_t r;
+			valid = valid && !__builtin_mul_overflow(a, b, &r);
+			return valid ? r : 0;
+		};
+		auto plus = [&](std::uint64_t a, std::uint64_t b) {
+			std::uint64_t r;
+			valid = valid && !__builtin_add_overflow(a, b, &r);
+			return valid ? r : 0;
+		};
+		const std::uint64_t rows = plus(h.n, 1);
+		const std::array<std::uint64_t, NumSections> bytes = {
+			times(rows, idx),
+			times(h.entries, idx),
+			times(h.category == 0 ? h.entries : 0, idx),
+			times(h.category == 2 ? rows : 0, idx),
+			times(h.inEntries, idx),
+			times(h.inEntries, idx),
+			times(h.n, h.vertexPropSize),
+			times(h.m, h.edgePropSize),
+		};
+		std::uint64_t pos = sizeof(BinaryHeader);
+		for(int i = 0; i != NumSections; ++i) {
+			pos = plus(pos, 63) / 64 * 64;
+			offset[i] = pos;
+			size[i] = bytes[i];
+			pos = plus(pos, bytes[i]);
+		}
+		total = pos;
+	}
+public:
+	std::array<std::uint64_t, NumSections> offset, size;
+	std::uint64_t total;
+	bool valid = true;
+};
+
+template<typename T>
+constexpr std::uint64_t binaryPropSize() {
+	if constexpr(std::is_same_v<T, NoProp>) {
+		return 0;
+	} else {
+		static_assert(std::is_trivially_copyable_v<T>,
+		              "Only trivially copyable properties can be stored in the binary format.");
+		return sizeof(T);
+	}
+}
+
+// A view of the given section of a mapped binary graph file as an array of T.
+template<typename T>
+std::span<const T> binarySection(const MappedFile &file, const BinaryLayout &layout,
+                                 BinaryLayout::Section s) {
+	const T *first = reinterpret_cast<const T*>(file.data() + layout.offset[s]);
+	return std::span<const T>(first, layout.size[s] / sizeof(T));
+}
+
+// Checks the counts of a binary graph file against each other, in O(1).
+// Returns the first problem found, or nullptr if there is none.
+inline const char *checkBinaryCounts(const BinaryHeader &h) {
+	const std::uint64_t entries = h.category == 0 ? 2 * h.m : h.m;
+	if(h.m > h.entries || h.entries != entries) return "Edge count mismatch.";
+	if(h.inEntries != (h.category == 2 ? h.m : 0)) return "In-edge count mismatch.";
+	return nullptr;
+}
+
+// Checks the arrays of a binary graph file against each other and the header, in one
+// linear pass: the offsets of each row must be non-decreasing and end at the number of
+// entries, and every vertex, edge id and entry must be in range, so that the graph never
+// reads outside them. Returns the first problem found, or nullptr if there is none.
+template<typename Arrays>
+const char *checkBinaryArrays(const BinaryHeader &h, const Arrays &a) {
+	auto badOffsets = [&](const auto &offsets, std::size_t last) {
+		if(offsets.front() != 0 || offsets.back() != last) return true;
+		for(std::size_t v = 0; v != h.n; ++v)
+			if(offsets[v] > offsets[v + 1]) return true;
+		return false;
+	};
+	auto outOfRange = [](const auto &values, std::size_t bound) {
+		for(std::size_t x : values)
+			if(x >= bound) return true;
+		return false;
+	};
+	if(badOffsets(a.offsets, h.entries)) return "Corrupt offsets.";
+	if(outOfRange(a.targets, h.n)) return "Target out of bounds.";
+	if(outOfRange(a.edgeIds, h.m)) return "Edge id out of bounds.";
+	if(h.category == 2) {
+		if(badOffsets(a.inOffsets, h.inEntries)) return "Corrupt in-offsets.";
+		if(outOfRange(a.inSources, h.n)) return "Source out of bounds.";
+		if(outOfRange(a.inEdgeIds, h.entries)) return "In-edge entry out of bounds.";
+	}
+	return nullptr;
+}
+
+// NoProp for graphs that do not declare property types.
+template<typename T>
+using PropOrNone = std::conditional_t<std::is_void_v<T>, NoProp, T>;
+
+} // namespace detail
+
+// Writes g to the file at path in a versioned binary format: a header followed by
+// the CSR arrays of g, see CompressedGraph, and its properties, if any, which must
+// be trivially copyable. Graphs other than CompressedGraph, e.g., AdjacencyList and
+// AdjacencyMatrix, are compressed first. Throws std::runtime_error on I/O errors.
+template<typename Graph>
+void saveBinary(const Graph &g, const std::string &path) {
+	if constexpr(!requires { g.arrays(); }) {
+		using Compressed = CompressedGraph<typename Traits<Graph>::DirectedCategory,
+		                                   detail::PropOrNone<typename Traits<Graph>::VertexProp>,
+		                                   detail::PropOrNone<typename Traits<Graph>::EdgeProp>>;
+		saveBinary(Compressed(g), path);
+	} else {
+		const auto &a = g.arrays();
+		detail::BinaryHeader h{};
+		std::memcpy(h.magic, detail::binaryMagic, sizeof(h.magic));
+		h.version = binaryFormatVersion;
+		h.byteOrder = detail::byteOrderMark;
+		h.category = detail::binaryCategory<typename Graph::DirectedCategory>();
+		h.indexSize = sizeof(std::size_t);
+		h.vertexPropSize = detail::binaryPropSize<typename Graph::VertexProp>();
+		h.edgePropSize = detail::binaryPropSize<typename Graph::EdgeProp>();
+		h.n = a.offsets.size() - 1;
+		h.m = a.numEdges;
+		h.entries = a.targets.size();
+		h.inEntries = a.inSources.size();
+		const detail::BinaryLayout layout(h);
+
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if(!out) throw std::runtime_error("Could not open '" + path + "' for writing.");
+		std::uint64_t pos = 0;
+		auto write = [&](std::uint64_t offset, const void *data, std::uint64_t bytes) {
+			static constexpr char zeros[64] = {};
+			out.write(zeros, offset - pos);
+			out.write(static_cast<const char*>(data), bytes);
+			pos = offset + bytes;
+		};
+		using L = detail::BinaryLayout;
+		write(0, &h, sizeof(h));
+		write(layout.offset[L::Offsets], a.offsets.data(), layout.size[L::Offsets]);
+		write(layout.offset[L::Targets], a.targets.data(), layout.size[L::Targets]);
+		write(layout.offset[L::EdgeIds], a.edgeIds.data(), layout.size[L::EdgeIds]);
+		write(layout.offset[L::InOffsets], a.inOffsets.data(), layout.size[L::InOffsets]);
+		write(layout.offset[L::InSources], a.inSources.data(), layout.size[L::InSources]);
+		write(layout.offset[L::InEdgeIds], a.inEdgeIds.data(), layout.size[L::InEdgeIds]);
+		write(layout.offset[L::VertexProps], a.vertexProps.data(), layout.size[L::VertexProps]);
+		write(layout.offset[L::EdgeProps], a.edgeProps.data(), layout.size[L::EdgeProps]);
+		if(!out.flush()) throw std::runtime_error("Could not write '" + path + "'.");
+	}
+}
+
+// How much of a binary graph file openBinary checks before viewing it.
+enum struct BinaryCheck {
+	Header, // the header, and that the sections it describes fit the file, in O(1)
+	Full    // also every entry of the index arrays, in one linear pass over them
+};
+
+// Opens a file written by saveBinary as a read-only CompressedGraph that views the
+// memory-mapped file directly, so nothing is parsed or copied and the pages are only
+// read when they are accessed. The mapping is released with the last copy of the graph.
+// The directed category and property types must match those saved, otherwise
+// std::runtime_error is thrown, as for files that are not valid.
+// By default only the header is checked, so opening costs O(1) plus page faults, and the
+// file must be trusted not to be corrupt within its sections. BinaryCheck::Full also
+// checks the index arrays, so that a corrupt file is rejected rather than read out of
+// bounds, at the cost of reading them on opening.
+template<typename DirectedCategory, typename VertexProp = NoProp, typename EdgeProp = NoProp>
+CompressedGraph<DirectedCategory, VertexProp, EdgeProp> openBinary(const std::string &path,
+                                                                   BinaryCheck check = BinaryCheck::Header) {
+	using Graph = CompressedGraph<DirectedCategory, VertexProp, EdgeProp>;
+	auto error = [&](auto &&msg) {
+		throw std::runtime_error("Binary graph '" + path + "': " + msg);
+	};
+	auto file = std::make_shared<detail::MappedFile>(path);
+	detail::BinaryHeader h;
+	if(file->size() < sizeof(h)) error("File is too small.");
+	std::memcpy(&h, file->data(), sizeof(h));
+	if(std::memcmp(h.magic, detail::binaryMagic, sizeof(h.magic)) != 0) error("Not a binary graph.");
+	if(h.version != binaryFormatVersion) error("Unsupported version " + std::to_string(h.version) + ".");
+	if(h.byteOrder != detail::byteOrderMark || h.indexSize != sizeof(std::size_t))
+		error("Saved on a machine with another byte order or index size.");
+	if(h.category != detail::binaryCategory<DirectedCategory>()) error("Directed category mismatch.");
+	if(h.vertexPropSize != detail::binaryPropSize<VertexProp>()) error("Vertex property mismatch.");
+	if(h.edgePropSize != detail::binaryPropSize<EdgeProp>()) error("Edge property mismatch.");
+	const detail::BinaryLayout layout(h);
+	if(!layout.valid) error("Corrupt header.");
+	if(const char *problem = detail::checkBinaryCounts(h)) error(problem);
+	if(file->size() < layout.total) error("File is truncated.");
+
+	using L = detail::BinaryLayout;
+	typename Graph::Arrays a;
+	a.numEdges = h.m;
+	a.offsets = detail::binarySection<std::size_t>(*file, layout, L::Offsets);
+	a.targets = detail::binarySection<std::size_t>(*file, layout, L::Targets);
+	a.edgeIds = detail::binarySection<std::size_t>(*file, layout, L::EdgeIds);
+	a.inOffsets = detail::binarySection<std::size_t>(*file, layout, L::InOffsets);
+	a.inSources = detail::binarySection<std::size_t>(*file, layout, L::InSources);
+	a.inEdgeIds = detail::binarySection<std::size_t>(*file, layout, L::InEdgeIds);
+	if constexpr(!std::is_same_v<VertexProp, NoProp>)
+		a.vertexProps = detail::binarySection<VertexProp>(*file, layout, L::VertexProps);
+	if constexpr(!std::is_same_v<EdgeProp, NoProp>)
+		a.edgeProps = detail::binarySection<EdgeProp>(*file, layout, L::EdgeProps);
+	if(a.offsets.front() != 0 || a.offsets.back() != h.entries) error("Corrupt offsets.");
+	if(check == BinaryCheck::Full)
+		if(const char *problem = detail::checkBinaryArrays(h, a)) error(problem);
+	return Graph(std::move(file), a);
+}
+
 // Print the given graph to the given output stream in the DOT format,
 // http://www.graphviz.org.
 // The given `VertexPrinter` and an `EdgePrinter` will be invoked inside the
@@ -0,0 +1,73 @@
+#ifndef GRAPH_MAPPED_FILE_HPP
+#define GRAPH_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace graph::detail {
+
+// A read-only, private memory mapping of a whole file (POSIX).
+// The mapping is released when the object is destroyed.
+// An empty file gives an empty mapping with data() == nullptr.
+struct MappedFile {
+	MappedFile() = default;
+
+	explicit MappedFile(const std::string &path) {
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if(fd == -1) throw std::runtime_error("Could not open '" + path + "'.");
+		struct stat st;
+		if(::fstat(fd, &st) == -1) {
+			::close(fd);
+			throw std::runtime_error("Could not stat '" + path + "'.");
+		}
+		len = static_cast<std::size_t>(st.st_size);
+		if(len != 0) {
+			void *p = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+			if(p == MAP_FAILED) {
+				::close(fd);
+				throw std::runtime_error("Could not map '" + path + "'.");
+			}
+			addr = static_cast<const char*>(p);
+		}
+		// the mapping stays valid after the descriptor is closed
+		::close(fd);
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile &operator=(const MappedFile&) = delete;
+
+	MappedFile(MappedFile &&other) noexcept
+		: addr(std::exchange(other.addr, nullptr)), len(std::exchange(other.len, 0)) {}
+
+	MappedFile &operator=(MappedFile &&other) noexcept {
+		std::swap(addr, other.addr);
+		std::swap(len, other.len);
+		return *this;
+	}
+
+	~MappedFile() {
+		if(addr) ::munmap(const_cast<char*>(addr), len);
+	}
+
+	// Hints the kernel that the mapping will be read front to back.
+	void adviseSequential() const {
+		if(addr) ::madvise(const_cast<char*>(addr), len, MADV_SEQUENTIAL);
+	}
+
+	const char *data() const { return addr; }
+	std::size_t size() const { return len; }
+private:
+	const char *addr = nullptr;
+	std::size_t len = 0;
+};
+
+} // namespace graph::detail
+
+#endif // GRAPH_MAPPED_FILE_HPP
@@ -0,0 +1,88 @@
+#ifndef GRAPH_PAGE_RANK_HPP
+#define GRAPH_PAGE_RANK_HPP
+
+#include "concepts.hpp"
+#include "parallel.hpp"
+#include "spmv.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace graph {
+namespace detail {
+
+template<typename T>
+inline constexpr bool isTransposedCSR = false;
+
+template<typename IndexT>
+inline constexpr bool isTransposedCSR<TransposedCSR<IndexT>> = true;
+
+} // namespace detail
+
+// PageRank by pull-based power iteration over the transpose a of a graph.
+// Returns the rank of each vertex by index, summing to 1. Each iteration spreads the
+// rank of each vertex evenly over its out-edges, gathered by the targets through one
+// PlusTimes spmv, and the rank of vertices without out-edges evenly over all vertices.
+// Stops once the ranks change by at most tolerance in sum, or after maxIterations.
+// Value may be float, halving the memory traffic of the gathers, or double.
+template<typename Value = double, typename IndexT>
+std::vector<Value> pageRank(const TransposedCSR<IndexT> &a, Value damping = Value(0.85),
+                            Value tolerance = Value(1e-6), std::size_t maxIterations = 100,
+                            ThreadPool &pool = defaultThreadPool()) {
+	constexpr std::size_t grain = 1 << 12;
+	const std::size_t n = a.numRows();
+	std::vector<Value> rank(n, n == 0 ? Value(0) : Value(1) / Value(n)), contribution(n), sum(n);
+	const std::size_t blocks = numBlocks(n, grain, pool);
+	std::vector<Value> dangling(blocks), change(blocks);
+	for(std::size_t it = 0; it != maxIterations && n != 0; ++it) {
+		parallelBlocks(0, n, grain, [&](std::size_t b, std::size_t first, std::size_t last) {
+			Value d = 0;
+			for(std::size_t u = first; u != last; ++u) {
+				if(a.outDegrees[u] == 0) {
+					d += rank[u];
+					contribution[u] = 0;
+				} else {
+					contribution[u] = rank[u] / Value(a.outDegrees[u]);
+				}
+			}
+			dangling[b] = d;
+		}, pool);
+		Value d = 0;
+		for(Value x : dangling) d += x;
+
+		spmv(a, contribution, sum, PlusTimes<Value>(), pool);
+
+		const Value base = (Value(1) - damping + damping * d) / Value(n);
+		parallelBlocks(0, n, grain, [&](std::size_t b, std::size_t first, std::size_t last) {
+			Value c = 0;
+			for(std::size_t v = first; v != last; ++v) {
+				const Value r = base + damping * sum[v];
+				c += std::abs(r - rank[v]);
+				rank[v] = r;
+			}
+			change[b] = c;
+		}, pool);
+		Value c = 0;
+		for(Value x : change) c += x;
+		if(c <= tolerance) break;
+	}
+	return rank;
+}
+
+// PageRank of g, e.g., an AdjacencyList or an AdjacencyMatrix, through its transpose
+// with 32-bit indices if the vertices fit, see above.
+template<typename Value = double, typename Graph>
+	requires (!detail::isTransposedCSR<Graph>) && VertexListGraph<Graph> && IncidenceGraph<Graph> && IndexedGraph<Graph>
+std::vector<Value> pageRank(const Graph &g, Value damping = Value(0.85), Value tolerance = Value(1e-6),
+                            std::size_t maxIterations = 100, ThreadPool &pool = defaultThreadPool()) {
+	if(numVertices(g) <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+		return pageRank<Value>(TransposedCSR<std::uint32_t>(g, pool), damping, tolerance, maxIterations, pool);
+	return pageRank<Value>(TransposedCSR<std::uint64_t>(g, pool), damping, tolerance, maxIterations, pool);
+}
+
+} // namespace graph
+
+#endif // GRAPH_PAGE_RANK_HPP
@@ -0,0 +1,66 @@
+#ifndef GRAPH_PARALLEL_HPP
+#define GRAPH_PARALLEL_HPP
+
+#include "concepts.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+namespace graph {
+
+// The number of blocks parallelBlocks splits a range of the given size into,
+// such that each block has at least minBlockSize elements.
+// There are up to a few blocks per thread of the pool, so uneven blocks are balanced.
+inline std::size_t numBlocks(std::size_t size, std::size_t minBlockSize,
+                             const ThreadPool &pool = defaultThreadPool()) {
+	const std::size_t byGrain = (size + minBlockSize - 1) / std::max<std::size_t>(minBlockSize, 1);
+	return std::max<std::size_t>(1, std::min(4 * pool.numThreads(), byGrain));
+}
+
+// Splits [first, last) into numBlocks(last - first, minBlockSize, pool) contiguous
+// blocks and calls f(block, blockFirst, blockLast) for each of them, as tasks on pool
+// that the calling thread helps run. f may itself run parallel loops on the same pool.
+// If any call throws, the first exception is rethrown after all blocks are done.
+template<typename F>
+void parallelBlocks(std::size_t first, std::size_t last, std::size_t minBlockSize, F f,
+                    ThreadPool &pool = defaultThreadPool()) {
+	const std::size_t size = last - first;
+	const std::size_t blocks = numBlocks(size, minBlockSize, pool);
+	if(blocks == 1) {
+		f(0, first, last);
+		return;
+	}
+	TaskGroup group(pool);
+	for(std::size_t b = 0; b != blocks; ++b)
+		group.run([&f, first, size, blocks, b] { f(b, first + size * b / blocks, first + size * (b + 1) / blocks); });
+	group.wait();
+}
+
+// Calls f(i) for each i in [first, last), in parallel blocks of at least minBlockSize.
+template<typename F>
+void parallelFor(std::size_t first, std::size_t last, F f, std::size_t minBlockSize = 1 << 12,
+                 ThreadPool &pool = defaultThreadPool()) {
+	parallelBlocks(first, last, minBlockSize, [&](std::size_t, std::size_t b, std::size_t e) {
+		for(std::size_t i = b; i != e; ++i) f(i);
+	}, pool);
+}
+
+// Calls f(v) for each vertex v of g, in parallel blocks of at least minBlockSize vertices.
+// Each block advances its own iterator of the VertexRange to its first vertex,
+// which is O(1) for the random access vertex ranges of the graphs in this library.
+template<typename Graph, typename F>
+	requires VertexListGraph<Graph>
+void parallelForVertices(const Graph &g, F f, std::size_t minBlockSize = 1 << 12,
+                         ThreadPool &pool = defaultThreadPool()) {
+	const auto vs = vertices(g);
+	parallelBlocks(0, numVertices(g), minBlockSize, [&](std::size_t, std::size_t b, std::size_t e) {
+		auto it = std::next(vs.begin(), b);
+		for(std::size_t i = b; i != e; ++i, ++it) f(*it);
+	}, pool);
+}
+
+} // namespace graph
+
+#endif // GRAPH_PARALLEL_HPP
@@ -0,0 +1,252 @@
+#ifndef GRAPH_REACHABILITY_HPP
+#define GRAPH_REACHABILITY_HPP
+
+#include "concepts.hpp"
+#include "parallel.hpp"
+#include "strongly_connected_components.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// An index answering whether a vertex reaches another in a fixed directed graph, built
+// once for many queries. Vertices in the same strongly connected component reach each
+// other, so the index works on the condensation of the graph, whose components are
+// numbered by Tarjan's algorithm in reverse topological order: a component can only
+// reach components with smaller ids. The index is then one of:
+// - The transitive closure as bits: row c holds a bit for each component c reaches.
+//   Since c reaches only components up to c, the rows form a triangle of about k^2 / 128
+//   bytes for k components. The rows are computed in order of id, each as the OR of the
+//   rows of its successors, a word at a time, and the columns of words are split between
+//   the threads. A query tests one bit.
+// - For graphs whose closure would exceed maxClosureBytes: the interval labels of GRAIL
+//   (Yildirim et al., GRAIL: Scalable Reachability Index for Large Graphs). Each of
+//   numLabels randomized DFS traversals, run in parallel, gives component c the interval
+//   [low, post] of the post-order numbers of what c reaches, so c can only reach d if the
+//   interval of d lies within that of c. Together with the lengths of the longest paths to
+//   a sink and from a source, which decrease and increase along edges, this rejects most
+//   unreachable pairs in O(1).
+//   Pairs of a DFS tree and its descendants are accepted in O(1), and the rest are decided
+//   by a search that skips every component the labels rule out.
+// Queries are const and may run concurrently.
+class ReachabilityIndex {
+public:
+	// Indexes the directed graph g, e.g., an AdjacencyList, a CompressedGraph or a VarintGraph.
+	template<typename Graph>
+		requires VertexListGraph<Graph> && IncidenceGraph<Graph> && IndexedGraph<Graph>
+	explicit ReachabilityIndex(const Graph &g, std::size_t maxClosureBytes = std::size_t(1) << 27,
+	                           std::size_t numLabels = 3, ThreadPool &pool = defaultThreadPool()) {
+		static_assert(std::derived_from<typename Traits<Graph>::DirectedCategory, tags::Directed>,
+		              "Reachability is indexed for directed graphs; use connected components otherwise.");
+		k = stronglyConnectedComponents(g, component);
+		// the condensation, in CSR format
+		std::vector<std::pair<std::size_t, std::size_t>> el;
+		for(auto u : vertices(g)) {
+			const std::size_t cu = component[getIndex(u, g)];
+			for(const auto &e : outEdges(u, g)) {
+				const std::size_t cv = component[getIndex(target(e, g), g)];
+				if(cu != cv) el.emplace_back(cu, cv);
+			}
+		}
+		std::sort(el.begin(), el.end());
+		el.erase(std::unique(el.begin(), el.end()), el.end());
+		offsets.assign(k + 1, 0);
+		for(const auto &[cu, cv] : el) ++offsets[cu + 1];
+		for(std::size_t c = 0; c != k; ++c) offsets[c + 1] += offsets[c];
+		targets.resize(el.size());
+		for(std::size_t i = 0; i != el.size(); ++i) targets[i] = el[i].second;
+		if(closureWords(k) * sizeof(Word) <= maxClosureBytes) buildClosure(pool);
+		else buildLabels(std::max<std::size_t>(numLabels, 1), pool);
+	}
+
+	// Whether the vertex with index u reaches the vertex with index v,
+	// i.e., u = v or there is a path from u to v.
+	bool reachable(std::size_t u, std::size_t v) const {
+		const std::size_t cu = component[u], cv = component[v];
+		if(cu == cv) return true;
+		if(cu < cv) return false;
+		if(!closure.empty()) return (closure[rowStart(cu) + cv / wordBits] >> (cv % wordBits)) & 1;
+		return search(cu, cv);
+	}
+
+	// Whether the index is the transitive closure, rather than labels.
+	bool isClosure() const {
+		return !closure.empty() || k == 0;
+	}
+
+	// The number of strongly connected components.
+	std::size_t numComponents() const {
+		return k;
+	}
+
+	// The size of the index, in bytes.
+	std::size_t memoryBytes() const {
+		return (component.size() + offsets.size() + targets.size()) * sizeof(std::size_t) + closure.size() * sizeof(Word)
+			+ (height.size() + depth.size() + low.size() + post.size() + pre.size()) * sizeof(std::size_t);
+	}
+private:
+	using Word = std::uint64_t;
+	static constexpr std::size_t wordBits = 64;
+
+	// Row c has the c / wordBits + 1 words that hold the bits of components 0 through c.
+	static std::size_t rowStart(std::size_t c) {
+		const std::size_t q = c / wordBits, r = c % wordBits;
+		return wordBits * (q * (q + 1) / 2) + r * (q + 1);
+	}
+
+	static std::size_t closureWords(std::size_t k) {
+		return rowStart(k);
+	}
+
+	// The components with an edge from c, all with smaller ids.
+	std::span<const std::size_t> successors(std::size_t c) const {
+		return std::span<const std::size_t>(targets.data() + offsets[c], targets.data() + offsets[c + 1]);
+	}
+
+	void buildClosure(ThreadPool &pool) {
+		closure.assign(closureWords(k), 0);
+		const std::size_t words = (k + wordBits - 1) / wordBits;
+		// Each block of word columns goes through all rows, from those of the sinks up.
+		parallelBlocks(0, words, 4, [&](std::size_t, std::size_t first, std::size_t last) {
+			for(std::size_t c = first * wordBits; c < k; ++c) {
+				const std::size_t w1 = std::min(last, c / wordBits + 1);
+				Word *row = closure.data() + rowStart(c);
+				for(std::size_t d : successors(c)) {
+					const Word *successor = closure.data() + rowStart(d);
+					const std::size_t end = std::min(w1, d / wordBits + 1);
+					for(std::size_t w = first; w < end; ++w) row[w] |= successor[w];
+				}
+				if(c / wordBits < last) row[c / wordBits] |= Word(1) << (c % wordBits);
+			}
+		}, pool);
+	}
+
+	void buildLabels(std::size_t numLabels, ThreadPool &pool) {
+		labels = numLabels;
+		height.assign(k, 0);
+		depth.assign(k, 0);
+		for(std::size_t c = 0; c != k; ++c)
+			for(std::size_t d : successors(c)) height[c] = std::max(height[c], height[d] + 1);
+		for(std::size_t c = k; c-- > 0;)
+			for(std::size_t d : successors(c)) depth[d] = std::max(depth[d], depth[c] + 1);
+		low.resize(labels * k);
+		post.resize(labels * k);
+		pre.resize(k);
+		// the traversals are independent, each fills its own slices
+		parallelFor(0, labels, [&](std::size_t t) { traverse(t); }, 1, pool);
+	}
+
+	// Randomized DFS t over the condensation: the roots are taken in a random order, and
+	// the successors of each component from a random offset. Sets post and low of t,
+	// and for t = 0 the pre-order numbers, which with post give the DFS forest.
+	void traverse(std::size_t t) {
+		std::size_t *postT = post.data() + t * k, *lowT = low.data() + t * k;
+		auto random = [t](std::size_t x) {
+			std::uint64_t z = (x + 1) * 0x9E3779B97F4A7C15ull + t * 0xD1B54A32D192ED03ull;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		};
+		std::vector<std::size_t> roots, inDegree(k, 0);
+		for(std::size_t d : targets) ++inDegree[d];
+		for(std::size_t c = 0; c != k; ++c)
+			if(inDegree[c] == 0) roots.push_back(c);
+		for(std::size_t i = roots.size(); i > 1; --i) std::swap(roots[i - 1], roots[random(i) % i]);
+
+		struct Frame {
+			std::size_t c, next, degree, offset;
+		};
+		std::vector<Frame> stack;
+		std::vector<char> visited(k, 0);
+		std::size_t preCount = 0, postCount = 0;
+		auto enter = [&](std::size_t c) {
+			visited[c] = 1;
+			if(t == 0) pre[c] = preCount++;
+			const std::size_t degree = offsets[c + 1] - offsets[c];
+			stack.push_back(Frame{c, 0, degree, degree == 0 ? 0 : random(c) % degree});
+		};
+		for(std::size_t r : roots) {
+			enter(r);
+			while(!stack.empty()) {
+				Frame &f = stack.back();
+				if(f.next == f.degree) {
+					postT[f.c] = postCount++;
+					stack.pop_back();
+					continue;
+				}
+				const std::size_t d = successors(f.c)[(f.offset + f.next++) % f.degree];
+				if(!visited[d]) enter(d);
+			}
+		}
+		// the successors of c have smaller ids
+		for(std::size_t c = 0; c != k; ++c) {
+			lowT[c] = postT[c];
+			for(std::size_t d : successors(c)) lowT[c] = std::min(lowT[c], lowT[d]);
+		}
+	}
+
+	// Whether the labels allow c to reach d.
+	bool mayReach(std::size_t c, std::size_t d) const {
+		if(c < d || height[c] <= height[d] || depth[c] >= depth[d]) return false;
+		for(std::size_t t = 0; t != labels; ++t) {
+			const std::size_t *lowT = low.data() + t * k, *postT = post.data() + t * k;
+			if(lowT[d] < lowT[c] || postT[d] > postT[c]) return false;
+		}
+		return true;
+	}
+
+	// Whether d is a descendant of c in the DFS forest of traversal 0, which implies that c reaches d.
+	bool isAncestor(std::size_t c, std::size_t d) const {
+		return pre[c] < pre[d] && post[d] < post[c];
+	}
+
+	// Whether component c, other than d, reaches d, by the labels or else a pruned DFS.
+	bool search(std::size_t c, std::size_t d) const {
+		if(!mayReach(c, d)) return false;
+		if(isAncestor(c, d)) return true;
+		// The scratch space of a thread is shared by its queries, the marks with a new epoch each.
+		thread_local std::vector<std::uint64_t> marks;
+		thread_local std::vector<std::size_t> stack;
+		thread_local std::uint64_t epoch = 0;
+		if(marks.size() < k) marks.resize(k, 0);
+		++epoch;
+		stack.assign(1, c);
+		marks[c] = epoch;
+		while(!stack.empty()) {
+			const std::size_t x = stack.back();
+			stack.pop_back();
+			// the successors are sorted by id, the last pushed, and so first searched, is the
+			// one nearest above d in the topological order
+			const auto next = successors(x);
+			for(auto it = next.rbegin(); it != next.rend(); ++it) {
+				const std::size_t y = *it;
+				if(y == d) return true;
+				if(marks[y] == epoch || !mayReach(y, d)) continue;
+				if(isAncestor(y, d)) return true;
+				marks[y] = epoch;
+				stack.push_back(y);
+			}
+		}
+		return false;
+	}
+private:
+	std::size_t k = 0; // the number of components
+	std::vector<std::size_t> component; // the component of each vertex, by index
+	std::vector<std::size_t> offsets, targets; // the condensation, in CSR format
+	std::vector<Word> closure; // the triangle of rows, if the closure is used
+	// The labels, if used: numLabels slices of k entries for low and post, and for the first
+	// traversal the pre-order numbers; the longest paths from each component to a sink, and
+	// from a source to it.
+	std::size_t labels = 0;
+	std::vector<std::size_t> height, depth, low, post, pre;
+};
+
+} // namespace graph
+
+#endif // GRAPH_REACHABILITY_HPP
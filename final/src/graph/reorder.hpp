@@ -0,0 +1,263 @@
+#ifndef GRAPH_REORDER_HPP
+#define GRAPH_REORDER_HPP
+
+#include "concepts.hpp"
+#include "generators.hpp"
+#include "io.hpp"
+#include "parallel.hpp"
+#include "properties.hpp"
+#include "tags.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Relabelling of the vertices of a graph, for locality: traversals touch the per-vertex
+// data of the neighbours of each vertex, which is in fewer cache lines and pages when
+// neighbours have close indices, or when the frequently touched vertices are together.
+// An order is given as a permutation newIndex, where newIndex[getIndex(v, g)] is the
+// index of v in the permuted copy returned by permute, and arrays indexed by getIndex
+// are permuted alongside by permuteProperties.
+namespace graph {
+namespace tags {
+
+// Selects the order by decreasing degree.
+struct DegreeOrder {};
+
+// Selects the order in which a breadth-first search discovers the vertices.
+struct BFSOrder {};
+
+// Selects the reverse Cuthill-McKee order.
+struct RCMOrder {};
+
+// Selects hub clustering: the vertices of above average degree first.
+struct HubClusterOrder {};
+
+} // namespace tags
+
+namespace detail {
+
+// The degree of each vertex by index, counting in-edges too if g has them.
+template<typename Graph>
+std::vector<std::size_t> totalDegrees(const Graph &g, ThreadPool &pool) {
+	std::vector<std::size_t> degree(numVertices(g));
+	parallelForVertices(g, [&](auto v) {
+		std::size_t d = outDegree(v, g);
+		if constexpr(BidirectionalGraph<Graph> && !std::is_same_v<typename Traits<Graph>::DirectedCategory, tags::Undirected>)
+			d += inDegree(v, g);
+		degree[getIndex(v, g)] = d;
+	}, 1 << 12, pool);
+	return degree;
+}
+
+// Calls f on the index of each neighbour of v, along out-edges and, if g has them, in-edges,
+// so directed graphs are searched as if undirected.
+template<typename Graph, typename Vertex, typename F>
+void forEachNeighbour(const Graph &g, Vertex v, F f) {
+	for(const auto &e : outEdges(v, g)) f(getIndex(target(e, g), g));
+	if constexpr(BidirectionalGraph<Graph> && !std::is_same_v<typename Traits<Graph>::DirectedCategory, tags::Undirected>) {
+		for(const auto &e : inEdges(v, g)) f(getIndex(source(e, g), g));
+	}
+}
+
+// The vertices in the order of breadth-first searches, each started from the unvisited
+// vertex that comes first by start, and, with byDegree, the neighbours of each vertex
+// discovered by increasing degree, as by Cuthill-McKee.
+template<typename Graph>
+std::vector<std::size_t> bfsSequence(const Graph &g, const std::vector<std::size_t> &starts,
+                                     const std::vector<std::size_t> *byDegree) {
+	const std::size_t n = starts.size();
+	std::vector<typename Traits<Graph>::VertexDescriptor> vs(n);
+	for(auto v : vertices(g)) vs[getIndex(v, g)] = v;
+	std::vector<char> visited(n, 0);
+	std::vector<std::size_t> sequence;
+	sequence.reserve(n);
+	for(std::size_t s : starts) {
+		if(visited[s]) continue;
+		visited[s] = 1;
+		sequence.push_back(s);
+		for(std::size_t k = sequence.size() - 1; k != sequence.size(); ++k) {
+			const std::size_t first = sequence.size();
+			forEachNeighbour(g, vs[sequence[k]], [&](std::size_t w) {
+				if(visited[w]) return;
+				visited[w] = 1;
+				sequence.push_back(w);
+			});
+			if(byDegree) {
+				std::sort(sequence.begin() + first, sequence.end(), [&](std::size_t a, std::size_t b) {
+					return std::tie((*byDegree)[a], a) < std::tie((*byDegree)[b], b);
+				});
+			}
+		}
+	}
+	return sequence;
+}
+
+// The permutation that puts the k-th vertex of the sequence at index k.
+inline std::vector<std::size_t> positions(const std::vector<std::size_t> &sequence) {
+	std::vector<std::size_t> newIndex(sequence.size());
+	for(std::size_t k = 0; k != sequence.size(); ++k) newIndex[sequence[k]] = k;
+	return newIndex;
+}
+
+} // namespace detail
+
+// The vertices by decreasing degree, ties by index, so the vertices of high degree,
+// which most edges lead to, share the first cache lines. Counting sort, O(n + max degree).
+template<typename Graph>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph> && IndexedGraph<Graph>
+std::vector<std::size_t> degreeOrder(const Graph &g, ThreadPool &pool = defaultThreadPool()) {
+	const std::vector<std::size_t> degree = detail::totalDegrees(g, pool);
+	const std::size_t maxDegree = degree.empty() ? 0 : *std::max_element(degree.begin(), degree.end());
+	// the first new index of each degree, from the largest
+	std::vector<std::size_t> next(maxDegree + 2, 0);
+	for(std::size_t d : degree) ++next[maxDegree - d + 1];
+	for(std::size_t k = 1; k != next.size(); ++k) next[k] += next[k - 1];
+	std::vector<std::size_t> newIndex(degree.size());
+	for(std::size_t i = 0; i != degree.size(); ++i) newIndex[i] = next[maxDegree - degree[i]]++;
+	return newIndex;
+}
+
+// The vertices in the order breadth-first searches discover them, each search started
+// from the unvisited vertex of smallest index. Directed graphs are searched along out-
+// and, if they have them, in-edges.
+template<typename Graph>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph> && IndexedGraph<Graph>
+std::vector<std::size_t> bfsOrder(const Graph &g) {
+	std::vector<std::size_t> starts(numVertices(g));
+	for(std::size_t i = 0; i != starts.size(); ++i) starts[i] = i;
+	return detail::positions(detail::bfsSequence(g, starts, nullptr));
+}
+
+// The reverse Cuthill-McKee order, which keeps the indices of neighbours close, i.e.,
+// the adjacency matrix near its diagonal: breadth-first searches that discover the
+// neighbours of each vertex by increasing degree, each started from an unvisited vertex
+// of smallest degree, reversed. Directed graphs are searched as by bfsOrder.
+template<typename Graph>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph> && IndexedGraph<Graph>
+std::vector<std::size_t> reverseCuthillMcKeeOrder(const Graph &g, ThreadPool &pool = defaultThreadPool()) {
+	const std::vector<std::size_t> degree = detail::totalDegrees(g, pool);
+	std::vector<std::size_t> starts(degree.size());
+	for(std::size_t i = 0; i != starts.size(); ++i) starts[i] = i;
+	std::stable_sort(starts.begin(), starts.end(), [&](std::size_t a, std::size_t b) {
+		return degree[a] < degree[b];
+	});
+	std::vector<std::size_t> sequence = detail::bfsSequence(g, starts, &degree);
+	std::reverse(sequence.begin(), sequence.end());
+	return detail::positions(sequence);
+}
+
+// Hub clustering: the vertices of above average degree first and the others after them,
+// each in their original relative order. It packs the hubs, which most edges lead to,
+// together, while keeping whatever locality the original order had, and is O(n).
+template<typename Graph>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph> && IndexedGraph<Graph>
+std::vector<std::size_t> hubClusterOrder(const Graph &g, ThreadPool &pool = defaultThreadPool()) {
+	const std::vector<std::size_t> degree = detail::totalDegrees(g, pool);
+	const std::size_t n = degree.size();
+	std::size_t total = 0;
+	for(std::size_t d : degree) total += d;
+	// d > total / n, without rounding
+	auto isHub = [&](std::size_t d) { return d * n > total; };
+	std::size_t hubs = 0;
+	for(std::size_t d : degree) hubs += isHub(d);
+	std::vector<std::size_t> newIndex(n);
+	std::size_t nextHub = 0, nextOther = hubs;
+	for(std::size_t i = 0; i != n; ++i) newIndex[i] = isHub(degree[i]) ? nextHub++ : nextOther++;
+	return newIndex;
+}
+
+// The inverse of a permutation, i.e., the old index of each new index.
+inline std::vector<std::size_t> inversePermutation(const std::vector<std::size_t> &newIndex) {
+	return detail::positions(newIndex);
+}
+
+// The per-vertex values of an array indexed by getIndex, moved along with the vertices:
+// the value of index newIndex[i] is values[i].
+template<typename T>
+std::vector<T> permuteProperties(const std::vector<T> &values, const std::vector<std::size_t> &newIndex,
+                                 ThreadPool &pool = defaultThreadPool()) {
+	assert(values.size() == newIndex.size());
+	std::vector<T> result(values.size());
+	parallelFor(0, values.size(), [&](std::size_t i) {
+		result[newIndex[i]] = values[i];
+	}, 1 << 12, pool);
+	return result;
+}
+
+// A copy of g with vertex i renumbered to newIndex[i], where the out-edges of each
+// vertex are sorted by the new index of their targets. Graphs without properties are
+// built in bulk, see loadDimacs. Graphs with properties are built through addVertex
+// and addEdge, with the properties copied over.
+template<typename Graph>
+	requires VertexListGraph<Graph> && EdgeListGraph<Graph> && IndexedGraph<Graph>
+Graph permute(const Graph &g, const std::vector<std::size_t> &newIndex, ThreadPool &pool = defaultThreadPool()) {
+	const std::size_t n = numVertices(g);
+	assert(newIndex.size() == n);
+	constexpr bool isUndirected = std::is_same_v<typename Traits<Graph>::DirectedCategory, tags::Undirected>;
+	constexpr bool hasProps = PropertyGraph<Graph> && !(std::is_same_v<typename Traits<Graph>::VertexProp, NoProp> &&
+	                                                    std::is_same_v<typename Traits<Graph>::EdgeProp, NoProp>);
+	if constexpr(!hasProps) {
+		std::vector<std::pair<std::size_t, std::size_t>> el;
+		el.reserve(numEdges(g));
+		for(const auto &e : edges(g)) el.emplace_back(newIndex[getIndex(source(e, g), g)], newIndex[getIndex(target(e, g), g)]);
+		return detail::buildFromEdges<Graph>(n, detail::simplify(n, std::move(el), isUndirected, pool), pool);
+	} else {
+		static_assert(MutablePropertyGraph<Graph>, "Graphs with properties are permuted through addVertex and addEdge.");
+		using Edge = typename Traits<Graph>::EdgeDescriptor;
+		const std::vector<std::size_t> oldIndex = inversePermutation(newIndex);
+		std::vector<typename Traits<Graph>::VertexDescriptor> vs(n);
+		for(auto v : vertices(g)) vs[getIndex(v, g)] = v;
+		Graph h;
+		for(std::size_t i = 0; i != n; ++i) addVertex(g[vs[oldIndex[i]]], h);
+		std::vector<typename Traits<Graph>::VertexDescriptor> hs(n);
+		for(auto v : vertices(h)) hs[getIndex(v, h)] = v;
+		std::vector<std::tuple<std::size_t, std::size_t, Edge>> el;
+		el.reserve(numEdges(g));
+		for(const auto &e : edges(g)) {
+			std::size_t u = newIndex[getIndex(source(e, g), g)], v = newIndex[getIndex(target(e, g), g)];
+			if(isUndirected && u > v) std::swap(u, v);
+			el.emplace_back(u, v, e);
+		}
+		std::sort(el.begin(), el.end(), [](const auto &a, const auto &b) {
+			return std::tie(std::get<0>(a), std::get<1>(a)) < std::tie(std::get<0>(b), std::get<1>(b));
+		});
+		for(const auto &[u, v, e] : el) addEdge(hs[u], hs[v], g[e], h);
+		return h;
+	}
+}
+
+// A graph permuted by one of the orders above, and the permutation.
+template<typename Graph>
+struct Reordered {
+	Graph graph;
+	std::vector<std::size_t> newIndex;
+};
+
+// Permutes g into the order selected by the tag, see degreeOrder, bfsOrder,
+// reverseCuthillMcKeeOrder and hubClusterOrder.
+template<typename Graph, typename Order>
+	requires VertexListGraph<Graph> && EdgeListGraph<Graph> && IncidenceGraph<Graph> && IndexedGraph<Graph>
+Reordered<Graph> reorder(const Graph &g, Order, ThreadPool &pool = defaultThreadPool()) {
+	std::vector<std::size_t> newIndex;
+	if constexpr(std::is_same_v<Order, tags::DegreeOrder>) {
+		newIndex = degreeOrder(g, pool);
+	} else if constexpr(std::is_same_v<Order, tags::BFSOrder>) {
+		newIndex = bfsOrder(g);
+	} else if constexpr(std::is_same_v<Order, tags::RCMOrder>) {
+		newIndex = reverseCuthillMcKeeOrder(g, pool);
+	} else {
+		static_assert(std::is_same_v<Order, tags::HubClusterOrder>, "Unknown vertex order.");
+		newIndex = hubClusterOrder(g, pool);
+	}
+	Graph h = permute(g, newIndex, pool);
+	return {std::move(h), std::move(newIndex)};
+}
+
+} // namespace graph
+
+#endif // GRAPH_REORDER_HPP
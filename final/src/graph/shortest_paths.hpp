@@ -0,0 +1,432 @@
+#ifndef GRAPH_SHORTEST_PATHS_HPP
+#define GRAPH_SHORTEST_PATHS_HPP
+
+#include "bfs.hpp"
+#include "concepts.hpp"
+#include "parallel.hpp"
+#include "traits.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+namespace tags {
+
+// Selects a 4-ary heap with decrease-key as the priority queue of dijkstra.
+struct DAryHeap {};
+
+// Selects a radix heap as the priority queue of dijkstra, for integral weights.
+struct RadixHeap {};
+
+} // namespace tags
+
+// Reads the weight of an edge from its edge property,
+// e.g., for AdjacencyList<tags::Directed, NoProp, double>.
+struct EdgePropWeight {
+	template<typename G, typename E>
+	decltype(auto) operator()(const E &e, const G &g) const {
+		return g[e];
+	}
+};
+
+namespace detail {
+
+// The type of the weights read by a weight accessor.
+template<typename Graph, typename WeightMap>
+using EdgeWeight = std::remove_cvref_t<
+	std::invoke_result_t<WeightMap&, const typename Traits<Graph>::EdgeDescriptor&, const Graph&>>;
+
+// A D-ary min-heap of indices with decrease-key. The entries are stored with their
+// keys, so sifting compares neighbouring memory only, and pos maps each index to its
+// entry, so the key of an index in the heap can be lowered in O(log_D n).
+template<typename Key, std::size_t D = 4>
+class DAryHeap {
+	using Entry = std::pair<Key, std::size_t>;
+	static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+public:
+	bool empty() const {
+		return heap.empty();
+	}
+
+	// Inserts i with the given key, or lowers the key of i if it is already in the heap.
+	void push(std::size_t i, Key key) {
+		if(i >= pos.size()) pos.resize(i + 1, npos);
+		std::size_t h = pos[i];
+		if(h == npos) {
+			h = heap.size();
+			heap.emplace_back(key, i);
+		} else {
+			assert(!(heap[h].first < key));
+			heap[h].first = key;
+		}
+		siftUp(h);
+	}
+
+	// Removes the entry with the smallest key and returns its key and index.
+	Entry pop() {
+		const Entry top = heap.front();
+		pos[top.second] = npos;
+		const Entry last = heap.back();
+		heap.pop_back();
+		if(!heap.empty()) {
+			place(0, last);
+			siftDown(0);
+		}
+		return top;
+	}
+private:
+	void place(std::size_t h, const Entry &e) {
+		heap[h] = e;
+		pos[e.second] = h;
+	}
+
+	void siftUp(std::size_t h) {
+		const Entry e = heap[h];
+		while(h != 0) {
+			const std::size_t p = (h - 1) / D;
+			if(!(e.first < heap[p].first)) break;
+			place(h, heap[p]);
+			h = p;
+		}
+		place(h, e);
+	}
+
+	void siftDown(std::size_t h) {
+		const Entry e = heap[h];
+		while(true) {
+			const std::size_t first = D * h + 1;
+			if(first >= heap.size()) break;
+			const std::size_t last = std::min(first + D, heap.size());
+			std::size_t best = first;
+			for(std::size_t c = first + 1; c < last; ++c)
+				if(heap[c].first < heap[best].first) best = c;
+			if(!(heap[best].first < e.first)) break;
+			place(h, heap[best]);
+			h = best;
+		}
+		place(h, e);
+	}
+private:
+	std::vector<Entry> heap;
+	std::vector<std::size_t> pos; // the entry of each index in the heap, or npos
+};
+
+// A monotone radix heap of indices with unsigned integer keys: keys pushed may not
+// be smaller than the last key popped. Bucket b holds the keys whose highest bit
+// differing from the last popped key is bit b - 1, so each key moves to lower
+// buckets at most 64 times. There is no decrease-key, an index is pushed again instead.
+class RadixHeap {
+	using Entry = std::pair<std::uint64_t, std::size_t>;
+public:
+	bool empty() const {
+		return count == 0;
+	}
+
+	void push(std::size_t i, std::uint64_t key) {
+		assert(key >= last);
+		buckets[bucketOf(key)].emplace_back(key, i);
+		++count;
+	}
+
+	// Removes an entry with the smallest key and returns its key and index.
+	Entry pop() {
+		if(buckets[0].empty()) {
+			std::size_t b = 1;
+			while(buckets[b].empty()) ++b;
+			std::vector<Entry> moved;
+			moved.swap(buckets[b]);
+			last = std::min_element(moved.begin(), moved.end())->first;
+			for(const Entry &e : moved) buckets[bucketOf(e.first)].push_back(e);
+		}
+		const Entry e = buckets[0].back();
+		buckets[0].pop_back();
+		--count;
+		return e;
+	}
+private:
+	std::size_t bucketOf(std::uint64_t key) const {
+		return std::bit_width(key ^ last);
+	}
+private:
+	std::array<std::vector<Entry>, 65> buckets;
+	std::uint64_t last = 0;
+	std::size_t count = 0;
+};
+
+template<typename W>
+using DefaultDijkstraQueue = std::conditional_t<std::is_integral_v<W>, tags::RadixHeap, tags::DAryHeap>;
+
+} // namespace detail
+
+// The distance of vertices that are not reachable from the source.
+template<typename W>
+inline constexpr W infiniteDistance = std::numeric_limits<W>::max();
+
+// Dijkstra's single-source shortest paths from s, with the non-negative weight of
+// an edge e given by weight(e, g).
+// Sets distance[getIndex(v, g)] to the length of a shortest path from s to v, and
+// parent[getIndex(v, g)] to the index of the vertex before v on it (s is its own
+// parent). Vertices not reachable from s get infiniteDistance and unreachable.
+// For graphs that are not a VertexListGraph, the vectors are only as long as the
+// largest index reached.
+// The queue is a 4-ary heap with decrease-key, or by default for integral weights a
+// radix heap, which makes the pushes and pops O(1) amortised apart from at most
+// 64 moves between buckets per pushed entry.
+template<typename Graph, typename WeightMap = EdgePropWeight,
+         typename Queue = detail::DefaultDijkstraQueue<detail::EdgeWeight<Graph, WeightMap>>>
+	requires IncidenceGraph<Graph> && IndexedGraph<Graph>
+void dijkstra(const Graph &g, typename Traits<Graph>::VertexDescriptor s,
+              std::vector<detail::EdgeWeight<Graph, WeightMap>> &distance, std::vector<std::size_t> &parent,
+              WeightMap weight = WeightMap(), Queue = Queue()) {
+	using Vertex = typename Traits<Graph>::VertexDescriptor;
+	using W = detail::EdgeWeight<Graph, WeightMap>;
+	static_assert(std::is_arithmetic_v<W>, "The weights must be arithmetic.");
+	static_assert(std::is_integral_v<W> || !std::is_same_v<Queue, tags::RadixHeap>,
+	              "The radix heap needs integral weights.");
+
+	// the descriptor of each vertex index reached
+	std::vector<Vertex> vs;
+	auto reach = [&](std::size_t i, Vertex v) {
+		if(i >= vs.size()) {
+			vs.resize(i + 1);
+			distance.resize(i + 1, infiniteDistance<W>);
+			parent.resize(i + 1, unreachable);
+		}
+		vs[i] = v;
+	};
+	distance.clear();
+	parent.clear();
+	if constexpr(VertexListGraph<Graph>) {
+		vs.resize(numVertices(g));
+		distance.resize(vs.size(), infiniteDistance<W>);
+		parent.resize(vs.size(), unreachable);
+	}
+	const std::size_t si = getIndex(s, g);
+	reach(si, s);
+	distance[si] = W();
+	parent[si] = si;
+
+	// Relaxes the out-edges of u, calling push(v, d) for every target whose distance is lowered.
+	auto relax = [&](std::size_t u, auto push) {
+		for(const auto &e : outEdges(vs[u], g)) {
+			const W w = weight(e, g);
+			assert(!(w < W()));
+			const Vertex t = target(e, g);
+			const std::size_t v = getIndex(t, g);
+			reach(v, t);
+			if(distance[u] + w < distance[v]) {
+				distance[v] = distance[u] + w;
+				parent[v] = u;
+				push(v, distance[v]);
+			}
+		}
+	};
+	if constexpr(std::is_same_v<Queue, tags::RadixHeap>) {
+		detail::RadixHeap queue;
+		queue.push(si, 0);
+		while(!queue.empty()) {
+			const auto [d, u] = queue.pop();
+			// skip entries of vertices that were pushed again with a smaller distance
+			if(d != static_cast<std::uint64_t>(distance[u])) continue;
+			relax(u, [&](std::size_t v, W dv) { queue.push(v, static_cast<std::uint64_t>(dv)); });
+		}
+	} else {
+		detail::DAryHeap<W> queue;
+		queue.push(si, W());
+		while(!queue.empty()) {
+			const std::size_t u = queue.pop().second;
+			relax(u, [&](std::size_t v, W dv) { queue.push(v, dv); });
+		}
+	}
+}
+
+// Parallel delta-stepping single-source shortest paths, with the same results as dijkstra.
+// The vertices are kept in buckets of distances [i * delta, (i + 1) * delta), and the
+// buckets are settled in order: the light edges (weight at most delta) of the vertices in
+// the current bucket are relaxed in parallel until it stays empty, as they may put vertices
+// back into it, then the heavy edges of all vertices settled in it are relaxed once.
+// Distances are lowered by compare-and-swap, and the parents are found afterwards
+// among the edges on shortest paths.
+// This form works on any IncidenceGraph with indices: n must exceed the index of every
+// vertex reachable from s, and distance and parent get n entries. The descriptor of each
+// vertex is taken from the edges that reach it. With delta 0, the mean weight of the
+// out-edges of s is used.
+template<typename Graph, typename WeightMap = EdgePropWeight>
+	requires IncidenceGraph<Graph> && IndexedGraph<Graph>
+void deltaStepping(const Graph &g, typename Traits<Graph>::VertexDescriptor s, std::size_t n,
+                   std::vector<detail::EdgeWeight<Graph, WeightMap>> &distance, std::vector<std::size_t> &parent,
+                   WeightMap weight = WeightMap(), detail::EdgeWeight<Graph, WeightMap> delta = {},
+                   ThreadPool &pool = defaultThreadPool()) {
+	using Vertex = typename Traits<Graph>::VertexDescriptor;
+	using W = detail::EdgeWeight<Graph, WeightMap>;
+	static_assert(std::is_arithmetic_v<W>, "The weights must be arithmetic.");
+	constexpr std::size_t grain = 1 << 10;
+
+	// the descriptor of each vertex index reached
+	std::vector<Vertex> vs(n);
+	distance.assign(n, infiniteDistance<W>);
+	parent.assign(n, unreachable);
+
+	if(delta == W()) {
+		double sum = 0;
+		std::size_t count = 0;
+		for(const auto &e : outEdges(s, g)) {
+			sum += weight(e, g);
+			++count;
+		}
+		delta = count == 0 ? W() : static_cast<W>(sum / count);
+		if(delta == W()) delta = W(1);
+	}
+	assert(W() < delta);
+	auto bucketOf = [&](W d) {
+		return static_cast<std::size_t>(d / delta);
+	};
+
+	// Relaxes the light or the heavy out-edges of the vertices in from, and returns the
+	// vertices whose distance was lowered, possibly repeated, with their descriptors.
+	auto relax = [&](const std::vector<std::size_t> &from, bool light) {
+		std::vector<std::vector<std::pair<std::size_t, Vertex>>> local(numBlocks(from.size(), grain, pool));
+		parallelBlocks(0, from.size(), grain, [&](std::size_t b, std::size_t first, std::size_t last) {
+			for(std::size_t k = first; k != last; ++k) {
+				const std::size_t u = from[k];
+				const W du = std::atomic_ref<W>(distance[u]).load(std::memory_order_relaxed);
+				for(const auto &e : outEdges(vs[u], g)) {
+					const W w = weight(e, g);
+					assert(!(w < W()));
+					if((w <= delta) != light) continue;
+					const Vertex tv = target(e, g);
+					const std::size_t v = getIndex(tv, g);
+					assert(v < n);
+					const W dv = du + w;
+					std::atomic_ref<W> current(distance[v]);
+					W old = current.load(std::memory_order_relaxed);
+					while(dv < old) {
+						if(current.compare_exchange_weak(old, dv, std::memory_order_relaxed)) {
+							local[b].emplace_back(v, tv);
+							break;
+						}
+					}
+				}
+			}
+		}, pool);
+		std::vector<std::pair<std::size_t, Vertex>> changed;
+		for(const auto &l : local) changed.insert(changed.end(), l.begin(), l.end());
+		return changed;
+	};
+
+	std::vector<std::vector<std::size_t>> buckets;
+	auto insert = [&](const std::vector<std::pair<std::size_t, Vertex>> &changed) {
+		for(const auto &[v, tv] : changed) {
+			vs[v] = tv;
+			const std::size_t b = bucketOf(distance[v]);
+			if(b >= buckets.size()) buckets.resize(b + 1);
+			buckets[b].push_back(v);
+		}
+	};
+	auto unique = [](std::vector<std::size_t> &vec) {
+		std::sort(vec.begin(), vec.end());
+		vec.erase(std::unique(vec.begin(), vec.end()), vec.end());
+	};
+
+	const std::size_t si = getIndex(s, g);
+	assert(si < n);
+	vs[si] = s;
+	distance[si] = W();
+	buckets.push_back({si});
+	for(std::size_t i = 0; i < buckets.size(); ++i) {
+		std::vector<std::size_t> settled;
+		while(!buckets[i].empty()) {
+			std::vector<std::size_t> frontier;
+			frontier.swap(buckets[i]);
+			unique(frontier);
+			// drop vertices that have since moved to a lower bucket
+			std::erase_if(frontier, [&](std::size_t v) { return bucketOf(distance[v]) != i; });
+			settled.insert(settled.end(), frontier.begin(), frontier.end());
+			insert(relax(frontier, true));
+		}
+		unique(settled);
+		insert(relax(settled, false));
+	}
+
+	// A parent of v is a u with distance[u] + weight == distance[v]. Taking only those
+	// with distance[u] < distance[v] first keeps zero-weight cycles out of the tree.
+	parent[si] = si;
+	parallelFor(0, n, [&](std::size_t u) {
+		if(distance[u] == infiniteDistance<W>) return;
+		for(const auto &e : outEdges(vs[u], g)) {
+			const std::size_t v = getIndex(target(e, g), g);
+			if(distance[u] < distance[v] && distance[u] + weight(e, g) == distance[v]) {
+				std::size_t none = unreachable;
+				std::atomic_ref<std::size_t>(parent[v]).compare_exchange_strong(none, u, std::memory_order_relaxed);
+			}
+		}
+	}, grain, pool);
+	// The remaining vertices are reached over edges of weight zero from vertices with a parent.
+	std::deque<std::size_t> queue;
+	for(std::size_t u = 0; u != n; ++u)
+		if(parent[u] != unreachable) queue.push_back(u);
+	const auto reached = std::count_if(distance.begin(), distance.end(),
+	                                   [](W d) { return d != infiniteDistance<W>; });
+	if(queue.size() == static_cast<std::size_t>(reached)) return;
+	while(!queue.empty()) {
+		const std::size_t u = queue.front();
+		queue.pop_front();
+		for(const auto &e : outEdges(vs[u], g)) {
+			const std::size_t v = getIndex(target(e, g), g);
+			if(parent[v] == unreachable && distance[u] + weight(e, g) == distance[v]) {
+				parent[v] = u;
+				queue.push_back(v);
+			}
+		}
+	}
+}
+
+// As above for a VertexListGraph, with n = numVertices(g). With delta 0, the mean weight
+// of all edges is used.
+template<typename Graph, typename WeightMap = EdgePropWeight>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph> && IndexedGraph<Graph>
+void deltaStepping(const Graph &g, typename Traits<Graph>::VertexDescriptor s,
+                   std::vector<detail::EdgeWeight<Graph, WeightMap>> &distance, std::vector<std::size_t> &parent,
+                   WeightMap weight = WeightMap(), detail::EdgeWeight<Graph, WeightMap> delta = {},
+                   ThreadPool &pool = defaultThreadPool()) {
+	using Vertex = typename Traits<Graph>::VertexDescriptor;
+	using W = detail::EdgeWeight<Graph, WeightMap>;
+	constexpr std::size_t grain = 1 << 10;
+	const std::size_t n = numVertices(g);
+	if(delta == W()) {
+		std::vector<Vertex> vs(n);
+		for(Vertex v : vertices(g)) vs[getIndex(v, g)] = v;
+		std::vector<std::pair<double, std::size_t>> sums(numBlocks(n, grain, pool));
+		parallelBlocks(0, n, grain, [&](std::size_t b, std::size_t first, std::size_t last) {
+			for(std::size_t u = first; u != last; ++u) {
+				for(const auto &e : outEdges(vs[u], g)) {
+					sums[b].first += weight(e, g);
+					++sums[b].second;
+				}
+			}
+		}, pool);
+		double sum = 0;
+		std::size_t count = 0;
+		for(const auto &[bs, bc] : sums) {
+			sum += bs;
+			count += bc;
+		}
+		delta = count == 0 ? W() : static_cast<W>(sum / count);
+		if(delta == W()) delta = W(1);
+	}
+	deltaStepping(g, s, n, distance, parent, weight, delta, pool);
+}
+
+} // namespace graph
+
+#endif // GRAPH_SHORTEST_PATHS_HPP
@@ -0,0 +1,245 @@
+#ifndef GRAPH_SPMV_HPP
+#define GRAPH_SPMV_HPP
+
+#include "concepts.hpp"
+#include "parallel.hpp"
+#include "traits.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace graph {
+
+// The transpose of the adjacency matrix of a graph in compressed sparse row form,
+// for pull-based kernels: row v lists the in-neighbours of v, i.e., the sources of
+// the edges into v, in increasing order of index.
+// Row v is sources[offsets[v]] through sources[offsets[v + 1] - 1], and outDegrees[u]
+// is the out-degree of u, which kernels such as PageRank scale by. Undirected edges
+// are in the rows of both end-points.
+template<typename IndexT = std::uint32_t>
+struct TransposedCSR {
+	using Index = IndexT;
+
+	std::vector<std::size_t> offsets{0};
+	std::vector<IndexT> sources;
+	std::vector<IndexT> outDegrees;
+
+	TransposedCSR() = default;
+
+	// Builds the transpose of g, e.g., an AdjacencyList or an AdjacencyMatrix.
+	// The entries are counted and placed in parallel, then each row is sorted.
+	template<typename Graph>
+		requires VertexListGraph<Graph> && IncidenceGraph<Graph> && IndexedGraph<Graph>
+	explicit TransposedCSR(const Graph &g, ThreadPool &pool = defaultThreadPool()) {
+		constexpr std::size_t grain = 1 << 10;
+		const std::size_t n = numVertices(g);
+		assert(n <= static_cast<std::size_t>(std::numeric_limits<IndexT>::max()));
+		std::vector<typename Traits<Graph>::VertexDescriptor> vs(n);
+		for(auto v : vertices(g)) vs[getIndex(v, g)] = v;
+
+		std::vector<std::atomic<std::size_t>> next(n);
+		outDegrees.resize(n);
+		parallelFor(0, n, [&](std::size_t u) {
+			std::size_t d = 0;
+			for(const auto &e : outEdges(vs[u], g)) {
+				next[getIndex(target(e, g), g)].fetch_add(1, std::memory_order_relaxed);
+				++d;
+			}
+			outDegrees[u] = static_cast<IndexT>(d);
+		}, grain, pool);
+		offsets.assign(n + 1, 0);
+		for(std::size_t v = 0; v != n; ++v) {
+			offsets[v + 1] = offsets[v] + next[v].load(std::memory_order_relaxed);
+			next[v].store(offsets[v], std::memory_order_relaxed);
+		}
+		sources.resize(offsets[n]);
+		parallelFor(0, n, [&](std::size_t u) {
+			for(const auto &e : outEdges(vs[u], g)) {
+				const std::size_t k = next[getIndex(target(e, g), g)].fetch_add(1, std::memory_order_relaxed);
+				sources[k] = static_cast<IndexT>(u);
+			}
+		}, grain, pool);
+		parallelFor(0, n, [&](std::size_t v) {
+			std::sort(sources.begin() + offsets[v], sources.begin() + offsets[v + 1]);
+		}, grain, pool);
+	}
+
+	std::size_t numRows() const {
+		return offsets.size() - 1;
+	}
+
+	std::size_t numEntries() const {
+		return sources.size();
+	}
+};
+
+// The (+, *) semiring, for sums of products.
+template<typename Value>
+struct PlusTimes {
+	static Value zero() { return Value(0); }
+	static Value one() { return Value(1); }
+	static Value add(Value a, Value b) { return a + b; }
+	static Value multiply(Value a, Value b) { return a * b; }
+};
+
+// The (min, +) semiring, for shortest-path relaxations.
+template<typename Value>
+struct MinPlus {
+	static Value zero() { return std::numeric_limits<Value>::max(); }
+	static Value one() { return Value(0); }
+	static Value add(Value a, Value b) { return std::min(a, b); }
+	static Value multiply(Value a, Value b) {
+		return a == zero() || b == zero() ? zero() : a + b;
+	}
+};
+
+// A semiring over Value: zero() is the identity of add, and one() that of multiply.
+template<typename S, typename Value>
+concept Semiring = requires(const S &s, Value a, Value b) {
+	{ s.zero() } -> std::convertible_to<Value>;
+	{ s.one() } -> std::convertible_to<Value>;
+	{ s.add(a, b) } -> std::convertible_to<Value>;
+	{ s.multiply(a, b) } -> std::convertible_to<Value>;
+};
+
+namespace detail {
+
+// Sums x[idx[0]], ..., x[idx[count - 1]], where x has n elements.
+// With AVX2 the elements are gathered 4 (double) or 8 (float) at a time into a vector
+// accumulator. The gathers take signed 32-bit offsets, so they are only used when every
+// index below n fits one. Otherwise four independent accumulators keep the additions from
+// waiting on each other. The order of the additions differs between the two.
+template<typename Value, typename IndexT>
+Value gatherSum(const Value *x, [[maybe_unused]] std::size_t n, const IndexT *idx, std::size_t count) {
+	std::size_t k = 0;
+	Value sum = 0;
+#if defined(__AVX2__)
+	const bool signedOffsets = n <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()) + 1;
+	if(signedOffsets) {
+		if constexpr(sizeof(IndexT) == 4 && std::is_same_v<Value, double>) {
+			// the masked forms, as the plain ones start from an undefined register
+			const __m256d zero = _mm256_setzero_pd(), all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+			__m256d acc = zero;
+			for(; k + 4 <= count; k += 4) {
+				const __m128i i = _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx + k));
+				acc = _mm256_add_pd(acc, _mm256_mask_i32gather_pd(zero, x, i, all, sizeof(double)));
+			}
+			alignas(32) double lanes[4];
+			_mm256_store_pd(lanes, acc);
+			sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		} else if constexpr(sizeof(IndexT) == 4 && std::is_same_v<Value, float>) {
+			const __m256 zero = _mm256_setzero_ps(), all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			__m256 acc = zero;
+			for(; k + 8 <= count; k += 8) {
+				const __m256i i = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + k));
+				acc = _mm256_add_ps(acc, _mm256_mask_i32gather_ps(zero, x, i, all, sizeof(float)));
+			}
+			alignas(32) float lanes[8];
+			_mm256_store_ps(lanes, acc);
+			sum = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+		}
+	}
+#endif
+	Value s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	for(; k + 4 <= count; k += 4) {
+		s0 += x[idx[k]];
+		s1 += x[idx[k + 1]];
+		s2 += x[idx[k + 2]];
+		s3 += x[idx[k + 3]];
+	}
+	for(; k != count; ++k) s0 += x[idx[k]];
+	return sum + ((s0 + s1) + (s2 + s3));
+}
+
+// Splits the rows of a into numBlocks(rows + entries, ...) contiguous blocks with about
+// the same number of rows plus entries each, so a few rows with many entries do not end
+// up in one block. Returns the first row of each block, and the number of rows last.
+template<typename IndexT>
+std::vector<std::size_t> rowBlocks(const TransposedCSR<IndexT> &a, std::size_t minBlockSize,
+                                   const ThreadPool &pool) {
+	const std::size_t rows = a.numRows(), work = rows + a.numEntries();
+	const std::size_t blocks = numBlocks(work, minBlockSize, pool);
+	std::vector<std::size_t> first(blocks + 1, rows);
+	first[0] = 0;
+	for(std::size_t b = 1; b != blocks; ++b) {
+		// the first row r with r + offsets[r] >= the share of the work before block b
+		const std::size_t share = work * b / blocks;
+		std::size_t lo = first[b - 1], hi = rows;
+		while(lo < hi) {
+			const std::size_t mid = lo + (hi - lo) / 2;
+			if(mid + a.offsets[mid] < share) lo = mid + 1;
+			else hi = mid;
+		}
+		first[b] = lo;
+	}
+	return first;
+}
+
+// Calls f(firstRow, lastRow) for blocks of rows balanced by rows plus entries, on the pool.
+template<typename IndexT, typename F>
+void parallelRows(const TransposedCSR<IndexT> &a, F f, ThreadPool &pool) {
+	const std::vector<std::size_t> first = rowBlocks(a, 1 << 12, pool);
+	parallelFor(0, first.size() - 1, [&](std::size_t b) {
+		f(first[b], first[b + 1]);
+	}, 1, pool);
+}
+
+} // namespace detail
+
+// The product y = A x over a semiring, with y resized to the rows of a, where A is the transpose in a, i.e.,
+// y[v] = add over the in-neighbours u of v of multiply(one(), x[u]), and zero() for none.
+// The rows are computed in parallel blocks of balanced work. For PlusTimes over float or
+// double the inner loop is a gather-and-accumulate.
+template<typename IndexT, typename Value, typename S = PlusTimes<Value>>
+	requires Semiring<S, Value>
+void spmv(const TransposedCSR<IndexT> &a, const std::vector<Value> &x, std::vector<Value> &y,
+          S semiring = S(), ThreadPool &pool = defaultThreadPool()) {
+	assert(x.size() == a.numRows());
+	y.resize(a.numRows());
+	detail::parallelRows(a, [&](std::size_t first, std::size_t last) {
+		for(std::size_t v = first; v != last; ++v) {
+			const std::size_t begin = a.offsets[v], end = a.offsets[v + 1];
+			if constexpr(std::is_same_v<S, PlusTimes<Value>> && std::is_floating_point_v<Value>) {
+				y[v] = detail::gatherSum(x.data(), x.size(), a.sources.data() + begin, end - begin);
+			} else {
+				Value acc = semiring.zero();
+				for(std::size_t k = begin; k != end; ++k)
+					acc = semiring.add(acc, semiring.multiply(semiring.one(), x[a.sources[k]]));
+				y[v] = acc;
+			}
+		}
+	}, pool);
+}
+
+// The product y = A x over a semiring with explicit entries: y[v] = add over k in row v
+// of multiply(values[k], x[sources[k]]), where values is aligned with a.sources.
+template<typename IndexT, typename Value, typename S = PlusTimes<Value>>
+	requires Semiring<S, Value>
+void spmv(const TransposedCSR<IndexT> &a, const std::vector<Value> &values, const std::vector<Value> &x,
+          std::vector<Value> &y, S semiring = S(), ThreadPool &pool = defaultThreadPool()) {
+	assert(values.size() == a.numEntries() && x.size() == a.numRows());
+	y.resize(a.numRows());
+	detail::parallelRows(a, [&](std::size_t first, std::size_t last) {
+		for(std::size_t v = first; v != last; ++v) {
+			Value acc = semiring.zero();
+			for(std::size_t k = a.offsets[v]; k != a.offsets[v + 1]; ++k)
+				acc = semiring.add(acc, semiring.multiply(values[k], x[a.sources[k]]));
+			y[v] = acc;
+		}
+	}, pool);
+}
+
+} // namespace graph
+
+#endif // GRAPH_SPMV_HPP
@@ -0,0 +1,296 @@
+#ifndef GRAPH_STRONGLY_CONNECTED_COMPONENTS_HPP
+#define GRAPH_STRONGLY_CONNECTED_COMPONENTS_HPP
+
+#include "adjacency_list.hpp"
+#include "concepts.hpp"
+#include "depth_first_search.hpp"
+#include "parallel.hpp"
+#include "tags.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+namespace detail {
+
+struct TarjanState {
+	std::vector<std::size_t> index, low, stack;
+	std::vector<char> onStack;
+	std::vector<std::size_t> *component;
+	std::size_t discovered = 0, count = 0;
+};
+
+// Tarjan's algorithm as DFS events. The visitor is copied by dfs, so the state is shared.
+struct TarjanVisitor : DFSNullVisitor {
+	TarjanVisitor(TarjanState &state) : s(&state) {}
+
+	template<typename G, typename V>
+	void discoverVertex(const V &v, const G &g) {
+		const std::size_t i = getIndex(v, g);
+		s->index[i] = s->low[i] = s->discovered++;
+		s->stack.push_back(i);
+		s->onStack[i] = 1;
+	}
+
+	// Called for every out-edge once it is done with, i.e., for tree edges after the
+	// subtree of the target is finished, so the low-link of the target is final.
+	template<typename G, typename E>
+	void finishEdge(const E &e, const G &g) {
+		const std::size_t u = getIndex(source(e, g), g), v = getIndex(target(e, g), g);
+		if(s->onStack[v]) s->low[u] = std::min(s->low[u], s->low[v]);
+	}
+
+	template<typename G, typename V>
+	void finishVertex(const V &v, const G &g) {
+		const std::size_t i = getIndex(v, g);
+		if(s->low[i] != s->index[i]) return;
+		// i is the root of a component, which is on the stack above it
+		std::size_t w;
+		do {
+			w = s->stack.back();
+			s->stack.pop_back();
+			s->onStack[w] = 0;
+			(*s->component)[w] = s->count;
+		} while(w != i);
+		++s->count;
+	}
+
+private:
+	TarjanState *s;
+};
+
+} // namespace detail
+
+// Strongly connected components by Tarjan's algorithm, on the iterative DFS,
+// so the depth of the graph is not limited by the call stack.
+// Sets component[getIndex(v, g)] to the id of the component of v and returns the number
+// of components. The ids are in reverse topological order of the components: an edge
+// between different components goes from the larger id to the smaller one.
+template<typename Graph>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph> && IndexedGraph<Graph>
+std::size_t stronglyConnectedComponents(const Graph &g, std::vector<std::size_t> &component) {
+	static_assert(std::derived_from<typename Traits<Graph>::DirectedCategory, tags::Directed>,
+	              "Strongly connected components are only defined for directed graphs.");
+	const std::size_t n = numVertices(g);
+	detail::TarjanState state;
+	state.index.resize(n);
+	state.low.resize(n);
+	state.onStack.assign(n, 0);
+	state.component = &component;
+	component.resize(n);
+	dfs(g, detail::TarjanVisitor(state), tags::DFSIterative());
+	return state.count;
+}
+
+namespace detail {
+
+// The forward-backward algorithm: the vertices that both reach and are reached from a
+// pivot form its component, and every other component lies entirely within the vertices
+// reached only forwards, only backwards, or not at all, which are solved independently.
+template<typename Graph>
+struct ForwardBackwardSCC {
+	static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+	const Graph &g;
+	ThreadPool &pool;
+	std::vector<typename Traits<Graph>::VertexDescriptor> vs;
+	std::vector<std::size_t> rep;  // the pivot of the component of each vertex, or none
+	std::vector<std::size_t> part; // the subproblem of each unsolved vertex
+	std::vector<char> forward, backward;
+	std::atomic<std::size_t> nextPart{1};
+
+	ForwardBackwardSCC(const Graph &g, ThreadPool &pool)
+		: g(g), pool(pool), vs(numVertices(g)), rep(vs.size(), none), part(vs.size(), 0),
+		  forward(vs.size(), 0), backward(vs.size(), 0) {
+		for(auto v : vertices(g)) vs[getIndex(v, g)] = v;
+	}
+
+	// Other tasks relabel their own vertices while this one looks at its neighbours.
+	std::size_t partOf(std::size_t v) {
+		return std::atomic_ref<std::size_t>(part[v]).load(std::memory_order_relaxed);
+	}
+
+	void setPart(std::size_t v, std::size_t p) {
+		std::atomic_ref<std::size_t>(part[v]).store(p, std::memory_order_relaxed);
+	}
+
+	// Marks the vertices of subproblem p reachable from the pivot, along out- or in-edges.
+	template<bool Forward>
+	void reach(std::size_t pivot, std::size_t p) {
+		std::vector<char> &mark = Forward ? forward : backward;
+		std::vector<std::size_t> queue{pivot};
+		mark[pivot] = 1;
+		for(std::size_t k = 0; k != queue.size(); ++k) {
+			auto visit = [&](std::size_t w) {
+				if(partOf(w) == p && !mark[w]) {
+					mark[w] = 1;
+					queue.push_back(w);
+				}
+			};
+			if constexpr(Forward) {
+				for(const auto &e : outEdges(vs[queue[k]], g)) visit(getIndex(target(e, g), g));
+			} else {
+				for(const auto &e : inEdges(vs[queue[k]], g)) visit(getIndex(source(e, g), g));
+			}
+		}
+	}
+
+	// Solves subproblem p with the given vertices. The largest of the three remaining
+	// parts is continued here and the others are spawned, so the tasks nest only as deep
+	// as the parts halve. The pivots are picked pseudo-randomly, as a pivot at the end of
+	// a long chain of components would split off only its own component.
+	void solve(std::vector<std::size_t> set, std::size_t p) {
+		TaskGroup group(pool);
+		while(!set.empty()) {
+			std::uint64_t x = (p + 1) * 0x9E3779B97F4A7C15ull;
+			x = (x ^ (x >> 31)) * 0xBF58476D1CE4E5B9ull;
+			const std::size_t pivot = set[static_cast<std::size_t>(x ^ (x >> 29)) % set.size()];
+			TaskGroup searches(pool);
+			searches.run([&] { reach<true>(pivot, p); });
+			reach<false>(pivot, p);
+			searches.wait();
+
+			std::vector<std::size_t> parts[3];
+			for(std::size_t v : set) {
+				if(forward[v] && backward[v]) {
+					rep[v] = pivot;
+					setPart(v, 0);
+				} else {
+					parts[forward[v] ? 0 : backward[v] ? 1 : 2].push_back(v);
+				}
+				forward[v] = backward[v] = 0;
+			}
+			std::sort(std::begin(parts), std::end(parts), [](const auto &a, const auto &b) {
+				return a.size() > b.size();
+			});
+			for(auto &q : parts) {
+				if(q.empty()) continue;
+				const std::size_t label = nextPart.fetch_add(1, std::memory_order_relaxed);
+				for(std::size_t v : q) setPart(v, label);
+				if(&q == &parts[0]) {
+					p = label;
+					continue;
+				}
+				group.run([this, q = std::move(q), label]() mutable { solve(std::move(q), label); });
+			}
+			set = std::move(parts[0]);
+		}
+		group.wait();
+	}
+
+	// Removes the vertices that cannot be on a cycle, as singleton components: repeatedly
+	// those without in-edges from the remaining vertices, then those without out-edges.
+	template<bool Forward>
+	void trim() {
+		const std::size_t n = vs.size();
+		constexpr std::size_t grain = 1 << 10;
+		std::vector<std::atomic<std::size_t>> degree(n);
+		parallelFor(0, n, [&](std::size_t u) {
+			if(rep[u] != none) return;
+			std::size_t d = 0;
+			if constexpr(Forward) {
+				for(const auto &e : inEdges(vs[u], g)) d += rep[getIndex(source(e, g), g)] == none;
+			} else {
+				for(const auto &e : outEdges(vs[u], g)) d += rep[getIndex(target(e, g), g)] == none;
+			}
+			degree[u].store(d, std::memory_order_relaxed);
+		}, grain, pool);
+		std::vector<std::size_t> frontier;
+		for(std::size_t u = 0; u != n; ++u)
+			if(rep[u] == none && degree[u].load(std::memory_order_relaxed) == 0) frontier.push_back(u);
+		while(!frontier.empty()) {
+			for(std::size_t u : frontier) rep[u] = u;
+			std::vector<std::vector<std::size_t>> local(numBlocks(frontier.size(), grain, pool));
+			parallelBlocks(0, frontier.size(), grain, [&](std::size_t b, std::size_t first, std::size_t last) {
+				auto peel = [&](std::size_t w) {
+					if(degree[w].fetch_sub(1, std::memory_order_relaxed) == 1) local[b].push_back(w);
+				};
+				for(std::size_t k = first; k != last; ++k) {
+					if constexpr(Forward) {
+						for(const auto &e : outEdges(vs[frontier[k]], g)) {
+							const std::size_t w = getIndex(target(e, g), g);
+							if(rep[w] == none) peel(w);
+						}
+					} else {
+						for(const auto &e : inEdges(vs[frontier[k]], g)) {
+							const std::size_t w = getIndex(source(e, g), g);
+							if(rep[w] == none) peel(w);
+						}
+					}
+				}
+			}, pool);
+			frontier.clear();
+			for(const auto &l : local) frontier.insert(frontier.end(), l.begin(), l.end());
+		}
+	}
+};
+
+} // namespace detail
+
+// Strongly connected components by the forward-backward algorithm, in parallel.
+// Sets component[getIndex(v, g)] to the id of the component of v and returns the number
+// of components, where the ids are 0, 1, ... in order of the smallest vertex index in
+// each component.
+// The vertices that cannot be on a cycle are first trimmed off level by level, then the
+// rest is split by forward-backward searches from pivots, where the two searches and the
+// independent subproblems run as tasks on the pool.
+template<typename Graph>
+	requires VertexListGraph<Graph> && BidirectionalGraph<Graph> && IndexedGraph<Graph>
+std::size_t parallelStronglyConnectedComponents(const Graph &g, std::vector<std::size_t> &component,
+                                                ThreadPool &pool = defaultThreadPool()) {
+	using Solver = detail::ForwardBackwardSCC<Graph>;
+	Solver s(g, pool);
+	const std::size_t n = s.vs.size();
+	s.template trim<true>();
+	s.template trim<false>();
+	std::vector<std::size_t> rest;
+	for(std::size_t u = 0; u != n; ++u) {
+		if(s.rep[u] == Solver::none) {
+			s.part[u] = 1;
+			rest.push_back(u);
+		}
+	}
+	s.nextPart = 2;
+	s.solve(std::move(rest), 1);
+
+	// the first vertex met of each component is its smallest
+	std::vector<std::size_t> label(n, Solver::none);
+	component.resize(n);
+	std::size_t count = 0;
+	for(std::size_t u = 0; u != n; ++u) {
+		std::size_t &l = label[s.rep[u]];
+		if(l == Solver::none) l = count++;
+		component[u] = l;
+	}
+	return count;
+}
+
+// The condensation of g: the DAG with a vertex for each of the count components, as
+// given by component, and an edge between two components if g has an edge between them.
+// Each edge is added once, and topoSort can be run on the result directly.
+template<typename Graph>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph> && IndexedGraph<Graph>
+AdjacencyList<tags::Directed> condensation(const Graph &g, const std::vector<std::size_t> &component,
+                                           std::size_t count) {
+	std::vector<std::pair<std::size_t, std::size_t>> el;
+	for(auto u : vertices(g)) {
+		const std::size_t cu = component[getIndex(u, g)];
+		for(const auto &e : outEdges(u, g)) {
+			const std::size_t cv = component[getIndex(target(e, g), g)];
+			if(cu != cv) el.emplace_back(cu, cv);
+		}
+	}
+	std::sort(el.begin(), el.end());
+	el.erase(std::unique(el.begin(), el.end()), el.end());
+	return AdjacencyList<tags::Directed>(count, el.begin(), el.end());
+}
+
+} // namespace graph
+
+#endif // GRAPH_STRONGLY_CONNECTED_COMPONENTS_HPP
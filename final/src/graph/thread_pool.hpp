@@ -0,0 +1,205 @@
+#ifndef GRAPH_THREAD_POOL_HPP
+#define GRAPH_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// The number of threads of the default thread pool, the calling thread included.
+inline std::size_t numThreads() {
+	const std::size_t n = std::thread::hardware_concurrency();
+	return n == 0 ? 1 : n;
+}
+
+// A work-stealing thread pool, the executor of the parallel algorithms.
+// Each worker has its own deque of tasks, pushing and popping its own tasks at
+// the back and, when it runs out, stealing from the front of the other deques.
+// Tasks spawned by threads outside the pool go to a deque of their own.
+// Tasks are run through a TaskGroup, whose wait() runs pending tasks of the
+// pool instead of blocking, so tasks may spawn and wait for nested tasks.
+// A pool with no workers runs all tasks in the threads that wait for them.
+class ThreadPool {
+	using Task = std::function<void()>;
+
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+public:
+	// Starts the given number of worker threads.
+	explicit ThreadPool(std::size_t workers = graph::numThreads() - 1)
+		: queues(workers + 1) {
+		for(auto &q : queues) q = std::make_unique<Queue>();
+		threads.reserve(workers);
+		for(std::size_t i = 0; i != workers; ++i)
+			threads.emplace_back([this, i] { work(i); });
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool &operator=(const ThreadPool&) = delete;
+
+	// Finishes the queued tasks and joins the workers.
+	~ThreadPool() {
+		{
+			std::lock_guard lock(sleepMutex);
+			stopping = true;
+		}
+		wakeUp.notify_all();
+		for(auto &t : threads) t.join();
+	}
+
+	// The number of threads working on tasks while a thread waits for them,
+	// i.e., the workers and the waiting thread.
+	std::size_t numThreads() const {
+		return threads.size() + 1;
+	}
+
+	// Queues f, on the deque of the calling worker, or else on the shared deque.
+	void spawn(Task f) {
+		Queue &q = *queues[currentQueue()];
+		// counted first, so queued never drops below the number of tasks in the deques
+		queued.fetch_add(1, std::memory_order_relaxed);
+		{
+			std::lock_guard lock(q.mutex);
+			q.tasks.push_back(std::move(f));
+		}
+		if(!threads.empty()) {
+			// taking the lock orders this with a worker checking queued before sleeping
+			{ std::lock_guard lock(sleepMutex); }
+			wakeUp.notify_one();
+		}
+	}
+
+	// Runs one queued task, preferring the newest one of the calling thread's deque.
+	// Returns false if no task was found.
+	bool runOne() {
+		const std::size_t own = currentQueue();
+		Task task;
+		if(!pop(*queues[own], task, true)) {
+			for(std::size_t k = 1; k != queues.size(); ++k)
+				if(pop(*queues[(own + k) % queues.size()], task, false)) break;
+		}
+		if(!task) return false;
+		queued.fetch_sub(1, std::memory_order_relaxed);
+		task();
+		return true;
+	}
+private:
+	static bool pop(Queue &q, Task &task, bool back) {
+		std::lock_guard lock(q.mutex);
+		if(q.tasks.empty()) return false;
+		if(back) {
+			task = std::move(q.tasks.back());
+			q.tasks.pop_back();
+		} else {
+			task = std::move(q.tasks.front());
+			q.tasks.pop_front();
+		}
+		return true;
+	}
+
+	// The pool and deque of the worker running in this thread, if any.
+	struct Current {
+		const ThreadPool *pool = nullptr;
+		std::size_t queue = 0;
+	};
+
+	static Current &current() {
+		static thread_local Current c;
+		return c;
+	}
+
+	// The deque of the calling thread: its own for workers, the shared one otherwise.
+	std::size_t currentQueue() const {
+		const Current &c = current();
+		return c.pool == this ? c.queue : queues.size() - 1;
+	}
+
+	void work(std::size_t i) {
+		current() = Current{this, i};
+		while(true) {
+			if(queued.load(std::memory_order_relaxed) != 0) {
+				runOne();
+				continue;
+			}
+			std::unique_lock lock(sleepMutex);
+			wakeUp.wait(lock, [&] { return stopping || queued.load(std::memory_order_relaxed) != 0; });
+			if(stopping && queued.load(std::memory_order_relaxed) == 0) return;
+		}
+	}
+private:
+	std::vector<std::unique_ptr<Queue>> queues; // one per worker, and the shared one last
+	std::vector<std::thread> threads;
+	std::atomic<std::size_t> queued{0}; // tasks spawned but not yet taken
+	std::mutex sleepMutex;
+	std::condition_variable wakeUp;
+	bool stopping = false;
+};
+
+// The pool used by the parallel algorithms when none is given,
+// with a worker for each hardware thread but the calling one.
+inline ThreadPool &defaultThreadPool() {
+	static ThreadPool pool;
+	return pool;
+}
+
+// A set of tasks spawned on a pool that can be waited for together.
+// The first exception thrown by a task is rethrown by wait().
+class TaskGroup {
+public:
+	explicit TaskGroup(ThreadPool &pool) : pool(pool) {}
+
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup &operator=(const TaskGroup&) = delete;
+
+	// Waits for the tasks, which refer to the group, but drops their exceptions.
+	~TaskGroup() {
+		help();
+	}
+
+	// Spawns f() on the pool.
+	template<typename F>
+	void run(F f) {
+		pending.fetch_add(1, std::memory_order_relaxed);
+		pool.spawn([this, f = std::move(f)]() mutable {
+			try {
+				f();
+			} catch(...) {
+				std::lock_guard lock(errorMutex);
+				if(!error) error = std::current_exception();
+			}
+			pending.fetch_sub(1, std::memory_order_release);
+		});
+	}
+
+	// Runs tasks of the pool until all tasks of the group are done.
+	void wait() {
+		help();
+		if(error) std::rethrow_exception(std::exchange(error, nullptr));
+	}
+private:
+	void help() {
+		while(pending.load(std::memory_order_acquire) != 0) {
+			if(!pool.runOne()) std::this_thread::yield();
+		}
+	}
+private:
+	ThreadPool &pool;
+	std::atomic<std::size_t> pending{0};
+	std::mutex errorMutex;
+	std::exception_ptr error;
+};
+
+} // namespace graph
+
+#endif // GRAPH_THREAD_POOL_HPP
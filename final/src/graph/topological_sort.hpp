@@ -1,7 +1,17 @@
 #ifndef GRAPH_TOPOLOGICAL_SORT_HPP
 #define GRAPH_TOPOLOGICAL_SORT_HPP
 
+#include "concepts.hpp"
 #include "depth_first_search.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
 
 namespace graph {
 namespace detail {
@@ -13,21 +23,158 @@ struct TopoVisitor : DFSNullVisitor {
 	template<typename G, typename V>
 	void finishVertex(const V &v, const G &) {
 		*iter = v;
-		*iter++;
+		++iter;
 	}
 
 private:
 	OIter iter;
 };
 
+// Merges the sorted a[0, la) and b[0, lb) into out[0, la + lb), in parallel pieces of
+// the output. The piece from position k takes a[i, ...) and b[k - i, ...), where i is
+// found by a binary search along the diagonal k, so every piece has the same length.
+template<typename T>
+void parallelMerge(const T *a, std::size_t la, const T *b, std::size_t lb, T *out, ThreadPool &pool) {
+	auto split = [&](std::size_t k) {
+		std::size_t lo = k > lb ? k - lb : 0, hi = std::min(k, la);
+		while(lo < hi) {
+			const std::size_t i = lo + (hi - lo) / 2;
+			// a[i] goes before b[k - i - 1], so the split is further along a
+			if(!(b[k - i - 1] < a[i])) lo = i + 1;
+			else hi = i;
+		}
+		return lo;
+	};
+	parallelBlocks(0, la + lb, 1 << 12, [&](std::size_t, std::size_t first, std::size_t last) {
+		const std::size_t i = split(first), iLast = split(last);
+		std::merge(a + i, a + iLast, b + (first - i), b + (last - iLast), out + first);
+	}, pool);
+}
+
+// Sorts data[offset.front(), offset.back()), made of the sorted runs
+// data[offset[r], offset[r + 1]), by merging neighbouring runs in rounds, each run
+// and each merge in parallel.
+template<typename T>
+void mergeRuns(std::vector<T> &data, std::vector<std::size_t> offset, ThreadPool &pool) {
+	const std::size_t first = offset.front();
+	std::vector<T> buffer(offset.back() - first);
+	T *from = data.data() + first, *to = buffer.data();
+	for(std::size_t &o : offset) o -= first;
+	while(offset.size() > 2) {
+		const std::size_t runs = offset.size() - 1, pairs = (runs + 1) / 2;
+		parallelFor(0, pairs, [&](std::size_t p) {
+			const std::size_t a = offset[2 * p], mid = offset[std::min(2 * p + 1, runs)];
+			const std::size_t b = offset[std::min(2 * p + 2, runs)];
+			parallelMerge<T>(from + a, mid - a, from + mid, b - mid, to + a, pool);
+		}, 1, pool);
+		std::vector<std::size_t> merged;
+		for(std::size_t p = 0; p != pairs; ++p) merged.push_back(offset[2 * p]);
+		merged.push_back(offset.back());
+		offset.swap(merged);
+		std::swap(from, to);
+	}
+	if(from != data.data() + first) {
+		parallelBlocks(0, buffer.size(), 1 << 14, [&](std::size_t, std::size_t b, std::size_t e) {
+			std::copy(from + b, from + e, data.data() + first + b);
+		}, pool);
+	}
+}
+
 } // namespace detail
 
-template<typename Graph, typename OutputIterator>
-void topoSort(const Graph &g, OutputIterator oIter) {
-	dfs(g, detail::TopoVisitor<OutputIterator>(oIter));
+// Writes the vertices of the DAG g to oIter in reverse topological order,
+// i.e., as they are finished by a DFS.
+// The iterative DFS is used by default, so long paths do not overflow the stack.
+template<typename Graph, typename OutputIterator, typename Implementation = tags::DFSIterative>
+void topoSort(const Graph &g, OutputIterator oIter, Implementation impl = Implementation()) {
+	dfs(g, detail::TopoVisitor<OutputIterator>(oIter), impl);
 }
 
 
+// The level of vertices that are not sorted by parallelTopoSort, because of a cycle.
+inline constexpr std::size_t noLevel = std::numeric_limits<std::size_t>::max();
+
+// Kahn-style topological sort, level by level.
+// The in-degrees are counted in parallel, then each level, or frontier, is the set of
+// vertices whose predecessors are all in earlier levels, and is expanded in parallel by
+// decrementing the in-degrees of its successors. Each frontier is sorted by index, in
+// parallel, so the result does not depend on the number of threads.
+// If g is acyclic, writes the vertices to oIter in topological order, i.e., sources
+// first and so reverse of topoSort, sets level[getIndex(v, g)] to the length of the
+// longest path ending in v, and returns true.
+// Otherwise writes nothing, sets the level of the vertices that are on or reachable
+// from a cycle to noLevel, and returns false.
+template<typename Graph, typename OutputIterator>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph>
+bool parallelTopoSort(const Graph &g, OutputIterator oIter, std::vector<std::size_t> &level,
+                      ThreadPool &pool = defaultThreadPool()) {
+	static_assert(std::derived_from<typename Traits<Graph>::DirectedCategory, tags::Directed>,
+	              "A topological order is only defined for directed graphs.");
+	using Vertex = typename Traits<Graph>::VertexDescriptor;
+	const std::size_t n = numVertices(g);
+	constexpr std::size_t grain = 1 << 10;
+
+	std::vector<Vertex> vs(n);
+	for(Vertex v : vertices(g)) vs[getIndex(v, g)] = v;
+
+	std::vector<std::atomic<std::size_t>> inDegree(n);
+	parallelFor(0, n, [&](std::size_t i) {
+		for(auto e : outEdges(vs[i], g))
+			inDegree[getIndex(target(e, g), g)].fetch_add(1, std::memory_order_relaxed);
+	}, grain, pool);
+
+	// The levels, one after the other, each sorted by index.
+	// order[levelBegin, order.size()) is the current frontier.
+	std::vector<std::size_t> order;
+	order.reserve(n);
+
+	// Expands blocks of [first, last) into per-block vectors of the indices found by
+	// visit(i, push), which each block sorts, and appends their sorted union to order:
+	// the blocks are copied to the offsets given by the prefix sums of their sizes, and
+	// the sorted runs merged, all in parallel. The indices are distinct, so the result
+	// does not depend on how the blocks are split.
+	auto collect = [&](std::size_t first, std::size_t last, auto visit) {
+		const std::size_t blocks = numBlocks(last - first, grain, pool);
+		std::vector<std::vector<std::size_t>> found(blocks);
+		parallelBlocks(first, last, grain, [&](std::size_t b, std::size_t bFirst, std::size_t bLast) {
+			auto push = [&](std::size_t j) { found[b].push_back(j); };
+			for(std::size_t i = bFirst; i != bLast; ++i) visit(i, push);
+			std::sort(found[b].begin(), found[b].end());
+		}, pool);
+		std::vector<std::size_t> offset(blocks + 1, order.size());
+		for(std::size_t b = 0; b != blocks; ++b) offset[b + 1] = offset[b] + found[b].size();
+		order.resize(offset.back());
+		parallelFor(0, blocks, [&](std::size_t b) {
+			std::copy(found[b].begin(), found[b].end(), order.begin() + offset[b]);
+		}, 1, pool);
+		detail::mergeRuns(order, std::move(offset), pool);
+	};
+
+	level.assign(n, noLevel);
+	collect(0, n, [&](std::size_t i, auto push) {
+		if(inDegree[i].load(std::memory_order_relaxed) == 0) push(i);
+	});
+	for(std::size_t levelBegin = 0, depth = 0; levelBegin != order.size(); ++depth) {
+		const std::size_t levelEnd = order.size();
+		parallelFor(levelBegin, levelEnd, [&](std::size_t k) { level[order[k]] = depth; }, grain, pool);
+		collect(levelBegin, levelEnd, [&](std::size_t k, auto push) {
+			for(auto e : outEdges(vs[order[k]], g)) {
+				const std::size_t j = getIndex(target(e, g), g);
+				// the last predecessor to be finished puts j in the next frontier
+				if(inDegree[j].fetch_sub(1, std::memory_order_acq_rel) == 1) push(j);
+			}
+		});
+		levelBegin = levelEnd;
+	}
+
+	if(order.size() != n) return false;
+	for(std::size_t i : order) {
+		*oIter = vs[i];
+		++oIter;
+	}
+	return true;
+}
+
 } // namespace graph
 
 #endif // GRAPH_TOPOLOGICAL_SORT_HPP
@@ -0,0 +1,353 @@
+#ifndef GRAPH_TRAVERSAL_RANGES_HPP
+#define GRAPH_TRAVERSAL_RANGES_HPP
+
+#include "concepts.hpp"
+#include "traits.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// The classification of an edge by a depth-first search, as in the DFS visitor events.
+// In undirected graphs the tree edges are seen again from their targets, as back edges.
+enum struct DFSEdgeKind {
+	Tree, Back, ForwardOrCross
+};
+
+// The classification of an edge by a breadth-first search, as in the BFS visitor events:
+// a tree edge discovers its target, the others lead to a queued (grey) or finished
+// (black) vertex.
+enum struct BFSEdgeKind {
+	Tree, GreyTarget, BlackTarget
+};
+
+// An examined edge, and how the traversal classified it.
+template<typename Edge, typename Kind>
+struct ClassifiedEdge {
+	Edge edge;
+	Kind kind;
+};
+
+namespace detail {
+
+// The colours of the vertices a traversal has reached, by index, in an open-addressing
+// hash table with linear probing that grows with them; all other vertices are white,
+// i.e., Colour{}. Unlike a colour per vertex, it costs nothing to create, so a traversal
+// that stops early pays only for the vertices it touched.
+template<typename Colour>
+class ColourMap {
+public:
+	Colour get(std::size_t key) const {
+		if(slots.empty()) return Colour{};
+		for(std::size_t i = bucket(key);; i = (i + 1) & mask()) {
+			if(slots[i].key == key) return slots[i].colour;
+			if(slots[i].key == empty) return Colour{};
+		}
+	}
+
+	void set(std::size_t key, Colour colour) {
+		// keep the load factor at most 1/2, so probe sequences stay short
+		if(2 * (count + 1) > slots.size()) grow();
+		std::size_t i = bucket(key);
+		while(slots[i].key != key && slots[i].key != empty) i = (i + 1) & mask();
+		if(slots[i].key == empty) ++count;
+		slots[i] = Slot{key, colour};
+	}
+private:
+	static constexpr std::size_t empty = std::numeric_limits<std::size_t>::max();
+
+	struct Slot {
+		std::size_t key = empty;
+		Colour colour{};
+	};
+
+	std::size_t mask() const {
+		return slots.size() - 1;
+	}
+
+	// The SplitMix64 finaliser of the key.
+	std::size_t bucket(std::size_t key) const {
+		std::uint64_t x = static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return static_cast<std::size_t>(x ^ (x >> 31)) & mask();
+	}
+
+	void grow() {
+		std::vector<Slot> old(slots.empty() ? 16 : 2 * slots.size());
+		old.swap(slots);
+		for(const Slot &s : old) {
+			if(s.key == empty) continue;
+			std::size_t i = bucket(s.key);
+			while(slots[i].key != empty) i = (i + 1) & mask();
+			slots[i] = s;
+		}
+	}
+private:
+	std::vector<Slot> slots; // the capacity is zero or a power of two
+	std::size_t count = 0;
+};
+
+// The state of a depth-first search from one vertex, stepped one examined edge at a time.
+// The edges are examined in the order of the DFS visitor events of the same search.
+template<typename Graph>
+class DFSCursor {
+public:
+	using Vertex = typename Traits<Graph>::VertexDescriptor;
+	using Kind = DFSEdgeKind;
+	using Event = ClassifiedEdge<typename Traits<Graph>::EdgeDescriptor, Kind>;
+public:
+	DFSCursor(const Graph &g, Vertex s) : g(&g), s(s) {
+		enter(s);
+	}
+
+	Vertex start() const {
+		return s;
+	}
+
+	const Graph &graph() const {
+		return *g;
+	}
+
+	// Examines the next edge, descending along it if it is a tree edge.
+	// Returns false once all vertices reachable from the start are finished.
+	bool next(Event &event) {
+		while(!stack.empty()) {
+			Frame &f = stack.back();
+			if(f.it == f.last) {
+				colour.set(getIndex(f.u, *g), Colour::Black);
+				stack.pop_back();
+				continue;
+			}
+			const auto e = *f.it;
+			++f.it;
+			const Vertex v = target(e, *g);
+			const Colour c = colour.get(getIndex(v, *g));
+			if(c == Colour::White) {
+				event = Event{e, Kind::Tree};
+				enter(v); // invalidates f
+			} else {
+				event = Event{e, c == Colour::Grey ? Kind::Back : Kind::ForwardOrCross};
+			}
+			return true;
+		}
+		return false;
+	}
+private:
+	enum struct Colour : unsigned char {
+		White, Grey, Black
+	};
+
+	struct Frame {
+		Vertex u;
+		typename Traits<Graph>::OutEdgeRange::iterator it, last;
+	};
+
+	void enter(Vertex v) {
+		colour.set(getIndex(v, *g), Colour::Grey);
+		auto range = outEdges(v, *g);
+		stack.push_back(Frame{v, range.begin(), range.end()});
+	}
+private:
+	const Graph *g;
+	Vertex s;
+	ColourMap<Colour> colour;
+	std::vector<Frame> stack;
+};
+
+// The state of a breadth-first search from one vertex, stepped one examined edge at a time.
+// The edges are examined in the order of the BFS visitor events of the same search.
+template<typename Graph>
+class BFSCursor {
+public:
+	using Vertex = typename Traits<Graph>::VertexDescriptor;
+	using Kind = BFSEdgeKind;
+	using Event = ClassifiedEdge<typename Traits<Graph>::EdgeDescriptor, Kind>;
+public:
+	BFSCursor(const Graph &g, Vertex s) : g(&g), s(s) {
+		colour.set(getIndex(s, g), Colour::Grey);
+		examine(s);
+	}
+
+	Vertex start() const {
+		return s;
+	}
+
+	const Graph &graph() const {
+		return *g;
+	}
+
+	// Examines the next edge, queueing its target if it is a tree edge.
+	// Returns false once all vertices reachable from the start are finished.
+	bool next(Event &event) {
+		while(it == last) {
+			colour.set(getIndex(u, *g), Colour::Black);
+			if(queue.empty()) return false;
+			examine(queue.front());
+			queue.pop();
+		}
+		const auto e = *it;
+		++it;
+		const Vertex v = target(e, *g);
+		const Colour c = colour.get(getIndex(v, *g));
+		if(c == Colour::White) {
+			colour.set(getIndex(v, *g), Colour::Grey);
+			queue.push(v);
+			event = Event{e, Kind::Tree};
+		} else {
+			event = Event{e, c == Colour::Grey ? Kind::GreyTarget : Kind::BlackTarget};
+		}
+		return true;
+	}
+private:
+	enum struct Colour : unsigned char {
+		White, Grey, Black
+	};
+
+	void examine(Vertex v) {
+		u = v;
+		auto range = outEdges(v, *g);
+		it = range.begin();
+		last = range.end();
+	}
+private:
+	const Graph *g;
+	Vertex s, u;
+	ColourMap<Colour> colour;
+	std::queue<Vertex> queue;
+	typename Traits<Graph>::OutEdgeRange::iterator it, last;
+};
+
+// A single-pass view over a traversal, yielding either the vertices in the order they
+// are discovered (the start, then the target of each tree edge), or the classified edges.
+// The cursor is only advanced as far as the iterator is, so leaving a loop over the range
+// ends the traversal there.
+template<typename Cursor, bool yieldsVertices>
+class TraversalRange : public std::ranges::view_interface<TraversalRange<Cursor, yieldsVertices>> {
+	using Event = typename Cursor::Event;
+	using Value = std::conditional_t<yieldsVertices, typename Cursor::Vertex, Event>;
+public:
+	class iterator {
+	public:
+		using value_type = Value;
+		using difference_type = std::ptrdiff_t;
+		using iterator_concept = std::input_iterator_tag;
+	public:
+		iterator() = default;
+
+		const Value &operator*() const {
+			return r->current;
+		}
+
+		iterator &operator++() {
+			r->advance();
+			return *this;
+		}
+
+		void operator++(int) {
+			++*this;
+		}
+
+		friend bool operator==(const iterator &i, std::default_sentinel_t) {
+			return i.finished();
+		}
+	private:
+		friend class TraversalRange;
+		explicit iterator(TraversalRange *r) : r(r) {}
+
+		bool finished() const {
+			return r->done;
+		}
+	private:
+		TraversalRange *r = nullptr;
+	};
+public:
+	template<typename Graph, typename Vertex>
+	TraversalRange(const Graph &g, Vertex s) : cursor(g, s) {}
+
+	TraversalRange(TraversalRange&&) = default;
+	TraversalRange &operator=(TraversalRange&&) = default;
+
+	// May be called once, the traversal cannot be restarted.
+	iterator begin() {
+		assert(!begun);
+		begun = true;
+		if constexpr(yieldsVertices) current = cursor.start();
+		else advance();
+		return iterator(this);
+	}
+
+	std::default_sentinel_t end() const {
+		return {};
+	}
+private:
+	void advance() {
+		Event event;
+		if constexpr(yieldsVertices) {
+			while(cursor.next(event))
+				if(event.kind == Cursor::Kind::Tree) {
+					current = target(event.edge, cursor.graph());
+					return;
+				}
+			done = true;
+		} else {
+			done = !cursor.next(event);
+			if(!done) current = event;
+		}
+	}
+private:
+	Cursor cursor;
+	Value current{};
+	bool begun = false, done = false;
+};
+
+} // namespace detail
+
+// A lazy depth-first search from s: a single-pass range of the vertices reachable from s,
+// in the order the DFS discovers them. Each increment examines only the edges up to the
+// next discovered vertex, so a search that stops at the first vertex it is looking for,
+// e.g., through std::ranges::find or std::views::take, touches no more of the graph than
+// that. The range holds the traversal state, a hash table of the colours of the vertices
+// reached so far and the DFS stack, so creating it does not depend on the size of g either.
+// It refers to g, which must outlive it and not change while it is in use.
+template<typename Graph>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph>
+auto dfsRange(const Graph &g, typename Traits<Graph>::VertexDescriptor s) {
+	return detail::TraversalRange<detail::DFSCursor<Graph>, true>(g, s);
+}
+
+// As dfsRange, yielding every examined edge as a ClassifiedEdge with a DFSEdgeKind.
+template<typename Graph>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph>
+auto dfsEdgeRange(const Graph &g, typename Traits<Graph>::VertexDescriptor s) {
+	return detail::TraversalRange<detail::DFSCursor<Graph>, false>(g, s);
+}
+
+// A lazy breadth-first search from s: a single-pass range of the vertices reachable
+// from s, in the order the BFS discovers them, i.e., by distance from s. As dfsRange,
+// each increment examines only the edges up to the next discovered vertex.
+template<typename Graph>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph>
+auto bfsRange(const Graph &g, typename Traits<Graph>::VertexDescriptor s) {
+	return detail::TraversalRange<detail::BFSCursor<Graph>, true>(g, s);
+}
+
+// As bfsRange, yielding every examined edge as a ClassifiedEdge with a BFSEdgeKind.
+template<typename Graph>
+	requires VertexListGraph<Graph> && IncidenceGraph<Graph>
+auto bfsEdgeRange(const Graph &g, typename Traits<Graph>::VertexDescriptor s) {
+	return detail::TraversalRange<detail::BFSCursor<Graph>, false>(g, s);
+}
+
+} // namespace graph
+
+#endif // GRAPH_TRAVERSAL_RANGES_HPP
@@ -0,0 +1,501 @@
+#ifndef GRAPH_VARINT_GRAPH_HPP
+#define GRAPH_VARINT_GRAPH_HPP
+
+#include "concepts.hpp"
+#include "tags.hpp"
+#include "traits.hpp"
+
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace graph {
+
+namespace tags {
+
+// Selects LEB128 varints for VarintGraph: 7 bits of a value per byte, low bits first,
+// with the top bit of each byte but the last set.
+struct Varint {
+};
+
+// Selects group varints for VarintGraph: values in groups of four, behind a control byte
+// holding the length of each, 1 to 4 bytes. A value is read as one little-endian word,
+// masked to its length, so decoding takes no branch per byte. Limits the graph to 2^31
+// vertices, so every value fits in 4 bytes.
+struct GroupVarint {
+};
+
+} // namespace tags
+
+namespace detail {
+
+// Zero bytes at the end of an encoded array, so the last value can be read as a whole word.
+inline constexpr std::size_t varintPadding = 3;
+
+inline std::uint64_t zigzag(std::int64_t x) {
+	return (static_cast<std::uint64_t>(x) << 1) ^ static_cast<std::uint64_t>(x >> 63);
+}
+
+inline std::int64_t unzigzag(std::uint64_t x) {
+	return static_cast<std::int64_t>(x >> 1) ^ -static_cast<std::int64_t>(x & 1);
+}
+
+inline void putVarint(std::vector<std::uint8_t> &out, std::uint64_t x) {
+	while(x >= 0x80) {
+		out.push_back(static_cast<std::uint8_t>(x) | 0x80);
+		x >>= 7;
+	}
+	out.push_back(static_cast<std::uint8_t>(x));
+}
+
+inline std::uint64_t getVarint(const std::uint8_t *&p) {
+	std::uint64_t x = 0;
+	for(unsigned shift = 0;; shift += 7) {
+		const std::uint8_t b = *p++;
+		x |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+		if(b < 0x80) return x;
+	}
+}
+
+// Appends a group of up to four values, with their control byte.
+inline void putGroupVarint(std::vector<std::uint8_t> &out, const std::uint32_t *values, std::size_t count) {
+	assert(count >= 1 && count <= 4);
+	const std::size_t control = out.size();
+	out.push_back(0);
+	for(std::size_t k = 0; k != count; ++k) {
+		const unsigned bytes = std::max(1u, (static_cast<unsigned>(std::bit_width(values[k])) + 7) / 8);
+		out[control] |= static_cast<std::uint8_t>((bytes - 1) << (2 * k));
+		for(unsigned b = 0; b != bytes; ++b)
+			out.push_back(static_cast<std::uint8_t>(values[k] >> (8 * b)));
+	}
+}
+
+// Reads a value of the given length, 1 to 4 bytes, from p, which has at least 4 readable bytes.
+inline std::uint32_t getGroupVarint(const std::uint8_t *p, unsigned bytes) {
+	std::uint32_t x;
+	if constexpr(std::endian::native == std::endian::little) {
+		std::memcpy(&x, p, sizeof(x));
+	} else {
+		x = 0;
+		for(unsigned b = 0; b != 4; ++b) x |= static_cast<std::uint32_t>(p[b]) << (8 * b);
+	}
+	return x & (~std::uint32_t(0) >> (32 - 8 * bytes));
+}
+
+// Reads the values of one row, one at a time, in either encoding.
+template<typename Encoding>
+struct VarintDecoder {
+	const std::uint8_t *p = nullptr; // the next unread byte
+	std::uint8_t control = 0; // GroupVarint: the control byte of the current group
+	unsigned k = 0; // GroupVarint: the position of the next value in its group
+
+	std::uint64_t next() {
+		if constexpr(std::is_same_v<Encoding, tags::GroupVarint>) {
+			if(k == 0) control = *p++;
+			const unsigned bytes = ((control >> (2 * k)) & 3) + 1;
+			const std::uint32_t x = getGroupVarint(p, bytes);
+			p += bytes;
+			k = (k + 1) & 3;
+			return x;
+		} else {
+			return getVarint(p);
+		}
+	}
+};
+
+} // namespace detail
+
+// An immutable graph storing each list of neighbours as compressed gaps, decoded on the
+// fly by the edge iterators, for graphs too large for an AdjacencyList or CompressedGraph.
+// The row of vertex v starts at byte offsets[v] of one byte array, and holds its degree
+// as a varint, followed by its neighbours in increasing order: the first as the zigzag
+// encoded difference to v, the others as the gap to the previous one minus one, as
+// varints (tags::Varint) or group varints (tags::GroupVarint). Neighbours with nearby
+// indices, e.g., after reorder, take a byte each; random ones about log2(n) / 7 bytes.
+// - For tags::Undirected each edge is stored in the rows of both end-points.
+// - For tags::Bidirectional the rows of the transposed graph hold the in-edges.
+// The graph is built once, either from another graph or from an edge list. The rows
+// are sorted by neighbour, and parallel edges are merged, so the out-edges of a vertex
+// may come in another order than in the input. Copies of graphs with the rows needed,
+// e.g., a CompressedGraph of the same category, and directed edge lists sorted by source
+// are encoded one row at a time, needing little memory beyond the encoded graph. Other
+// inputs are first sorted into rows of uncompressed neighbours, 8 bytes per entry.
+// Edges carry no id, and an EdgeDescriptor is just the pair of end-points, so the graph
+// has no edge properties; nor does it have vertex properties.
+template<typename DirectedCategoryT, typename EncodingT = tags::Varint>
+struct VarintGraph {
+private:
+	static constexpr bool isUndirected = std::is_same_v<DirectedCategoryT, tags::Undirected>;
+	static constexpr bool isBidirectional = std::is_same_v<DirectedCategoryT, tags::Bidirectional>;
+	static constexpr bool isGroupVarint = std::is_same_v<EncodingT, tags::GroupVarint>;
+	using Bytes = std::vector<std::uint8_t>;
+	using Offsets = std::vector<std::size_t>;
+public: // Graph
+	using DirectedCategory = DirectedCategoryT;
+	using Encoding = EncodingT;
+	using VertexDescriptor = std::size_t;
+
+	struct EdgeDescriptor {
+		EdgeDescriptor() = default;
+		EdgeDescriptor(std::size_t src, std::size_t tar) : src(src), tar(tar) {}
+	public:
+		std::size_t src, tar;
+	public:
+		// Parallel edges are merged, so an edge is identified by its end-points,
+		// in either order for undirected graphs.
+		friend bool operator==(const EdgeDescriptor &a, const EdgeDescriptor &b) {
+			if(a.src == b.src && a.tar == b.tar) return true;
+			return isUndirected && a.src == b.tar && a.tar == b.src;
+		}
+	};
+public: // VertexList
+	struct VertexRange {
+		// the iterator is simply a counter that returns its value when dereferenced
+		using iterator = boost::counting_iterator<VertexDescriptor>;
+	public:
+		VertexRange(std::size_t n) : n(n) {}
+		iterator begin() const { return iterator(0); }
+		iterator end()   const { return iterator(n); }
+	private:
+		std::size_t n;
+	};
+private:
+	// The edges of one row, of out-edges or, if isIn, of in-edges, of vertex v.
+	template<bool isIn>
+	struct RowRange {
+		// The iterator decodes the row as it goes: it holds the current neighbour, the
+		// number of neighbours left, including the current one, and where the next gap
+		// starts. It refers to the bytes of the graph only, not to the range.
+		struct iterator : boost::iterator_facade<
+				iterator, EdgeDescriptor,
+				std::forward_iterator_tag, EdgeDescriptor> {
+		public:
+			// also the end of every row
+			iterator() = default;
+
+			iterator(VertexDescriptor v, const std::uint8_t *row) : v(v) {
+				decoder.p = row;
+				left = detail::getVarint(decoder.p);
+				if(left != 0) u = v + detail::unzigzag(decoder.next());
+			}
+		private:
+			friend class boost::iterator_core_access;
+
+			EdgeDescriptor dereference() const {
+				if constexpr(isIn) return EdgeDescriptor{u, v};
+				else return EdgeDescriptor{v, u};
+			}
+
+			bool equal(const iterator &other) const {
+				return left == other.left;
+			}
+
+			void increment() {
+				if(--left != 0) u += decoder.next() + 1;
+			}
+		private:
+			VertexDescriptor v = 0, u = 0;
+			std::size_t left = 0;
+			detail::VarintDecoder<Encoding> decoder;
+		};
+	public:
+		RowRange(VertexDescriptor v, const std::uint8_t *row) : v(v), row(row) {}
+
+		iterator begin() const {
+			return iterator(v, row);
+		}
+
+		iterator end() const {
+			return iterator();
+		}
+	private:
+		VertexDescriptor v;
+		const std::uint8_t *row;
+	};
+public: // Incidence
+	using OutEdgeRange = RowRange<false>;
+public: // Bidirectional
+	using InEdgeRange = RowRange<true>;
+public: // EdgeList
+	struct EdgeRange {
+		// We walk the rows of all vertices in order. Undirected edges are stored twice,
+		// so only the copy where the source is the smaller end-point is reported.
+		struct iterator : boost::iterator_facade<
+				iterator, EdgeDescriptor,
+				std::forward_iterator_tag, EdgeDescriptor> {
+		public:
+			iterator() = default;
+
+			iterator(VertexDescriptor u, const VarintGraph *g) : u(u), g(g) {
+				if(u < numVertices(*g)) row = outEdges(u, *g).begin();
+				settle();
+			}
+		private:
+			friend class boost::iterator_core_access;
+
+			EdgeDescriptor dereference() const {
+				return *row;
+			}
+
+			bool equal(const iterator &other) const {
+				return u == other.u && row == other.row;
+			}
+
+			void increment() {
+				++row;
+				settle();
+			}
+
+			// Advance to the next reported edge, if the current one is not.
+			void settle() {
+				const std::size_t n = numVertices(*g);
+				while(u < n) {
+					if(row == typename OutEdgeRange::iterator()) {
+						if(++u < n) row = outEdges(u, *g).begin();
+					} else if(isUndirected && (*row).tar < u) {
+						++row;
+					} else {
+						return;
+					}
+				}
+			}
+		private:
+			VertexDescriptor u = 0;
+			typename OutEdgeRange::iterator row;
+			const VarintGraph *g = nullptr;
+		};
+	public:
+		EdgeRange(const VarintGraph *g) : g(g) {}
+
+		iterator begin() const {
+			return iterator(0, g);
+		}
+
+		iterator end() const {
+			return iterator(numVertices(*g), g);
+		}
+	private:
+		const VarintGraph *g;
+	};
+public:
+	// Constructs a graph with no vertices.
+	VarintGraph() : offsets(1, 0), bytes(detail::varintPadding, 0) {}
+
+	// Constructs a graph with n vertices and the edges in [first, last).
+	// Each element must be destructurable into a source and a target index,
+	// e.g., a std::pair<std::size_t, std::size_t>.
+	// Requires two passes over the range: one to count degrees and one to fill, unless
+	// the graph is directed and the edges are sorted by source, which is checked first.
+	template<std::forward_iterator EdgeIter>
+	VarintGraph(std::size_t n, EdgeIter first, EdgeIter last) {
+		auto sourceOf = [](const auto &edge) {
+			const auto &[src, tar] = edge;
+			return static_cast<std::size_t>(src);
+		};
+		if constexpr(!isUndirected && !isBidirectional) {
+			if(std::is_sorted(first, last, [&](const auto &a, const auto &b) { return sourceOf(a) < sourceOf(b); })) {
+				// the row of each vertex is the next run of edges
+				EdgeIter it = first;
+				m = encodeRows(n, offsets, bytes, [&](std::size_t v, Offsets &row) {
+					for(; it != last && sourceOf(*it) == v; ++it) {
+						const auto &[src, tar] = *it;
+						assert(static_cast<std::size_t>(tar) < n);
+						row.push_back(static_cast<std::size_t>(tar));
+					}
+				});
+				assert(it == last);
+				return;
+			}
+		}
+		build(n, [&](auto &&emit) {
+			for(EdgeIter it = first; it != last; ++it) {
+				const auto &[src, tar] = *it;
+				emit(static_cast<std::size_t>(src), static_cast<std::size_t>(tar));
+			}
+		});
+	}
+
+	// Constructs a compressed copy of g, e.g., an AdjacencyList or a CompressedGraph,
+	// with the vertices renumbered by getIndex.
+	template<typename G>
+		requires VertexListGraph<G> && EdgeListGraph<G>
+	explicit VarintGraph(const G &g) {
+		using Category = typename Traits<G>::DirectedCategory;
+		constexpr bool hasRows = isUndirected ? IncidenceGraph<G> && std::is_same_v<Category, tags::Undirected>
+			: isBidirectional ? BidirectionalGraph<G>
+			: IncidenceGraph<G> && std::derived_from<Category, tags::Directed>;
+		if constexpr(hasRows) {
+			// the out-edges, and in-edges, of g are the rows
+			const std::size_t n = numVertices(g);
+			std::vector<typename Traits<G>::VertexDescriptor> byIndex(n);
+			for(auto v : vertices(g)) byIndex[getIndex(v, g)] = v;
+			const std::size_t entries = encodeRows(n, offsets, bytes, [&](std::size_t v, Offsets &row) {
+				for(auto e : outEdges(byIndex[v], g)) row.push_back(getIndex(target(e, g), g));
+			});
+			m = isUndirected ? entries / 2 : entries;
+			if constexpr(isBidirectional)
+				encodeRows(n, inOffsets, inBytes, [&](std::size_t v, Offsets &row) {
+					for(auto e : inEdges(byIndex[v], g)) row.push_back(getIndex(source(e, g), g));
+				});
+		} else {
+			build(numVertices(g), [&](auto &&emit) {
+				for(auto e : edges(g))
+					emit(getIndex(source(e, g), g), getIndex(target(e, g), g));
+			});
+		}
+	}
+
+	// The size of the encoded graph, in bytes.
+	std::size_t memoryBytes() const {
+		return (offsets.size() + inOffsets.size()) * sizeof(std::size_t) + bytes.size() + inBytes.size();
+	}
+private:
+	// Counting sort of the edges produced by forEachEdge into rows of neighbours, each
+	// of which is then sorted, deduplicated and encoded.
+	template<typename ForEachEdge>
+	void build(std::size_t n, ForEachEdge forEachEdge) {
+		Offsets rowStarts(n + 1, 0), inRowStarts(isBidirectional ? n + 1 : 0, 0);
+		forEachEdge([&](std::size_t src, std::size_t tar) {
+			assert(src < n && tar < n);
+			++rowStarts[src + 1];
+			if constexpr(isUndirected) ++rowStarts[tar + 1];
+			if constexpr(isBidirectional) ++inRowStarts[tar + 1];
+		});
+		for(std::size_t v = 0; v < n; ++v) {
+			rowStarts[v + 1] += rowStarts[v];
+			if constexpr(isBidirectional) inRowStarts[v + 1] += inRowStarts[v];
+		}
+		Offsets neighbours(rowStarts[n]), inNeighbours(isBidirectional ? inRowStarts[n] : 0);
+		Offsets next(rowStarts.begin(), rowStarts.end() - 1);
+		Offsets inNext(inRowStarts.begin(), inRowStarts.empty() ? inRowStarts.end() : inRowStarts.end() - 1);
+		forEachEdge([&](std::size_t src, std::size_t tar) {
+			neighbours[next[src]++] = tar;
+			if constexpr(isUndirected) {
+				assert(src != tar);
+				neighbours[next[tar]++] = src;
+			}
+			if constexpr(isBidirectional) inNeighbours[inNext[tar]++] = src;
+		});
+		const std::size_t entries = encode(n, rowStarts, neighbours, offsets, bytes);
+		if constexpr(isBidirectional) encode(n, inRowStarts, inNeighbours, inOffsets, inBytes);
+		m = isUndirected ? entries / 2 : entries;
+	}
+
+	// Encodes the rows of neighbours, and returns the number of neighbours left
+	// after removing duplicates.
+	static std::size_t encode(std::size_t n, const Offsets &rowStarts, Offsets &neighbours,
+	                          Offsets &offsets, Bytes &bytes) {
+		bytes.reserve(neighbours.size() + n + detail::varintPadding);
+		return encodeRows(n, offsets, bytes, [&](std::size_t v, Offsets &row) {
+			row.assign(neighbours.begin() + rowStarts[v], neighbours.begin() + rowStarts[v + 1]);
+		});
+	}
+
+	// Encodes the rows that fillRow(v, row) appends to the empty row for each vertex v in
+	// order, and returns the number of neighbours left after removing duplicates.
+	template<typename FillRow>
+	static std::size_t encodeRows(std::size_t n, Offsets &offsets, Bytes &bytes, FillRow fillRow) {
+		assert(!isGroupVarint || n <= (std::size_t(1) << 31));
+		offsets.resize(n + 1);
+		bytes.clear();
+		std::size_t entries = 0;
+		Offsets row;
+		std::vector<std::uint32_t> gaps;
+		for(std::size_t v = 0; v < n; ++v) {
+			offsets[v] = bytes.size();
+			row.clear();
+			fillRow(v, row);
+			std::sort(row.begin(), row.end());
+			row.erase(std::unique(row.begin(), row.end()), row.end());
+			entries += row.size();
+			detail::putVarint(bytes, row.size());
+			std::size_t previous = v;
+			for(auto it = row.begin(); it != row.end(); ++it) {
+				const std::uint64_t gap = it == row.begin()
+					? detail::zigzag(static_cast<std::int64_t>(*it) - static_cast<std::int64_t>(v))
+					: *it - previous - 1;
+				previous = *it;
+				if constexpr(isGroupVarint) gaps.push_back(static_cast<std::uint32_t>(gap));
+				else detail::putVarint(bytes, gap);
+			}
+			if constexpr(isGroupVarint) {
+				for(std::size_t k = 0; k < gaps.size(); k += 4)
+					detail::putGroupVarint(bytes, gaps.data() + k, std::min<std::size_t>(4, gaps.size() - k));
+				gaps.clear();
+			}
+		}
+		offsets[n] = bytes.size();
+		bytes.insert(bytes.end(), detail::varintPadding, 0);
+		bytes.shrink_to_fit();
+		return entries;
+	}
+
+	// The number of neighbours of the row at p.
+	static std::size_t degree(const std::uint8_t *p) {
+		return detail::getVarint(p);
+	}
+private:
+	std::size_t m = 0;
+	Offsets offsets, inOffsets; // n + 1 row starts into bytes and inBytes
+	Bytes bytes, inBytes; // the encoded rows, padded
+public: // Graph
+	friend VertexDescriptor source(const EdgeDescriptor &e, const VarintGraph&) {
+		return e.src;
+	}
+
+	friend VertexDescriptor target(const EdgeDescriptor &e, const VarintGraph&) {
+		return e.tar;
+	}
+public: // VertexList
+	friend std::size_t numVertices(const VarintGraph &g) {
+		return g.offsets.size() - 1;
+	}
+
+	friend VertexRange vertices(const VarintGraph &g) {
+		return VertexRange(numVertices(g));
+	}
+public: // EdgeList
+	friend std::size_t numEdges(const VarintGraph &g) {
+		return g.m;
+	}
+
+	friend EdgeRange edges(const VarintGraph &g) {
+		return EdgeRange(&g);
+	}
+public: // Incidence
+	friend OutEdgeRange outEdges(VertexDescriptor v, const VarintGraph &g) {
+		return OutEdgeRange(v, g.bytes.data() + g.offsets[v]);
+	}
+
+	friend std::size_t outDegree(VertexDescriptor v, const VarintGraph &g) {
+		return degree(g.bytes.data() + g.offsets[v]);
+	}
+public: // Bidirectional
+	friend InEdgeRange inEdges(VertexDescriptor v, const VarintGraph &g)
+		requires isBidirectional {
+		return InEdgeRange(v, g.inBytes.data() + g.inOffsets[v]);
+	}
+
+	friend std::size_t inDegree(VertexDescriptor v, const VarintGraph &g)
+		requires isBidirectional {
+		return degree(g.inBytes.data() + g.inOffsets[v]);
+	}
+public: // Other
+	friend std::size_t getIndex(VertexDescriptor v, const VarintGraph&) {
+		return v;
+	}
+};
+
+} // namespace graph
+
+#endif // GRAPH_VARINT_GRAPH_HPP
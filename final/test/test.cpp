@@ -1,11 +1,50 @@
 #include "../src/graph/adjacency_list.hpp"
+#include "../src/graph/adjacency_matrix.hpp"
+#include "../src/graph/bfs.hpp"
+#include "../src/graph/compressed_graph.hpp"
+#include "../src/graph/concurrent_graph.hpp"
+#include "../src/graph/concepts.hpp"
+#include "../src/graph/connected_components.hpp"
+#include "../src/graph/degree_histogram.hpp"
 #include "../src/graph/depth_first_search.hpp"
+#include "../src/graph/dynamic_dag.hpp"
+#include "../src/graph/generators.hpp"
+#include "../src/graph/io.hpp"
+#include "../src/graph/page_rank.hpp"
+#include "../src/graph/parallel.hpp"
+#include "../src/graph/reachability.hpp"
+#include "../src/graph/reorder.hpp"
+#include "../src/graph/shortest_paths.hpp"
+#include "../src/graph/spmv.hpp"
+#include "../src/graph/strongly_connected_components.hpp"
+#include "../src/graph/thread_pool.hpp"
 #include "../src/graph/topological_sort.hpp"
+#include "../src/graph/traversal_ranges.hpp"
+#include "../src/graph/varint_graph.hpp"
 #include <iostream>
+#include <string>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 using vertex = graph::AdjacencyList<graph::tags::Directed>::VertexDescriptor;
-using edge = graph::AdjacencyList<graph::tags::Directed>::EdgeDescriptor;
+using edge_descriptor = graph::AdjacencyList<graph::tags::Directed>::EdgeDescriptor;
 
 
 int test_directed_graph_creation() {
@@ -95,6 +134,2082 @@ int test_copyable() {
     return 0;
 }
 
+int test_compressed_graph_concepts() {
+    using Directed = graph::CompressedGraph<graph::tags::Directed>;
+    using Bidirectional = graph::CompressedGraph<graph::tags::Bidirectional>;
+    using Undirected = graph::CompressedGraph<graph::tags::Undirected>;
+
+    static_assert(graph::VertexListGraph<Directed>);
+    static_assert(graph::EdgeListGraph<Directed>);
+    static_assert(graph::IncidenceGraph<Directed>);
+    static_assert(!graph::BidirectionalGraph<Directed>);
+    static_assert(graph::BidirectionalGraph<Bidirectional>);
+    static_assert(graph::EdgeListGraph<Undirected>);
+    static_assert(graph::IncidenceGraph<Undirected>);
+
+    return 0;
+}
+
+int test_compressed_graph_from_adjacency_list() {
+    graph::AdjacencyList<graph::tags::Directed> g(6);
+
+    addEdge(5, 2, g);
+    addEdge(5, 0, g);
+    addEdge(4, 0, g);
+    addEdge(4, 1, g);
+    addEdge(2, 3, g);
+    addEdge(3, 1, g);
+
+    graph::CompressedGraph<graph::tags::Directed> cg(g);
+    assert(numVertices(cg) == numVertices(g));
+    assert(numEdges(cg) == numEdges(g));
+    assert(outDegree(5, cg) == 2);
+    assert(outDegree(0, cg) == 0);
+
+    // The out-edges keep the insertion order of the adjacency list
+    std::vector<std::pair<vertex, vertex>> expected, actual;
+    for (auto v : vertices(g))
+        for (auto e : outEdges(v, g))
+            expected.emplace_back(source(e, g), target(e, g));
+    for (auto v : vertices(cg))
+        for (auto e : outEdges(v, cg))
+            actual.emplace_back(source(e, cg), target(e, cg));
+    assert(expected == actual);
+
+    // So the DFS based algorithms give the same result
+    std::vector<vertex> order(numVertices(g)), compressedOrder(numVertices(cg));
+    topoSort(g, order.begin());
+    topoSort(cg, compressedOrder.begin());
+    assert(order == compressedOrder);
+
+    std::size_t m = 0;
+    for (auto e : edges(cg))
+    {
+        assert(e.idx == m);
+        ++m;
+    }
+    assert(m == 6);
+
+    return 0;
+}
+
+int test_compressed_graph_from_edge_list() {
+    std::vector<std::pair<std::size_t, std::size_t>> el = {{0, 1}, {2, 1}, {1, 3}, {0, 3}};
+
+    graph::CompressedGraph<graph::tags::Bidirectional> g(4, el.begin(), el.end());
+    assert(numEdges(g) == 4);
+    assert(inDegree(1, g) == 2);
+    assert(inDegree(3, g) == 2);
+    assert(inDegree(0, g) == 0);
+    // In-edges compare equal to the corresponding out-edges
+    for (auto v : vertices(g))
+        for (auto e : inEdges(v, g))
+        {
+            assert(target(e, g) == v);
+            bool found = false;
+            for (auto f : outEdges(source(e, g), g))
+                found = found || (f == e && target(f, g) == v);
+            assert(found);
+        }
+
+    graph::CompressedGraph<graph::tags::Undirected> ug(4, el.begin(), el.end());
+    assert(numEdges(ug) == 4);
+    assert(outDegree(1, ug) == 3);
+    assert(outDegree(3, ug) == 2);
+    std::size_t m = 0;
+    for (auto e : edges(ug))
+    {
+        assert(source(e, ug) < target(e, ug));
+        ++m;
+    }
+    assert(m == 4);
+
+    graph::CompressedGraph<graph::tags::Directed> empty;
+    assert(numVertices(empty) == 0);
+    assert(edges(empty).begin() == edges(empty).end());
+
+    return 0;
+}
+
+// Records every DFS event as a string, so two traversals can be compared
+struct RecordingVisitor : graph::DFSNullVisitor {
+    RecordingVisitor(std::vector<std::string> *log) : log(log) {}
+
+    template <typename G, typename V>
+    void initVertex(const V &v, const G &) { add("init", v); }
+    template <typename G, typename V>
+    void startVertex(const V &v, const G &) { add("start", v); }
+    template <typename G, typename V>
+    void discoverVertex(const V &v, const G &) { add("discover", v); }
+    template <typename G, typename V>
+    void finishVertex(const V &v, const G &) { add("finish", v); }
+    template <typename G, typename E>
+    void examineEdge(const E &e, const G &g) { add("examine", source(e, g), target(e, g)); }
+    template <typename G, typename E>
+    void treeEdge(const E &e, const G &g) { add("tree", source(e, g), target(e, g)); }
+    template <typename G, typename E>
+    void backEdge(const E &e, const G &g) { add("back", source(e, g), target(e, g)); }
+    template <typename G, typename E>
+    void forwardOrCrossEdge(const E &e, const G &g) { add("forwardOrCross", source(e, g), target(e, g)); }
+    template <typename G, typename E>
+    void finishEdge(const E &e, const G &g) { add("finishEdge", source(e, g), target(e, g)); }
+
+private:
+    void add(const std::string &event, std::size_t u, std::size_t v = -1) {
+        log->push_back(event + " " + std::to_string(u) + " " + std::to_string(v));
+    }
+
+    std::vector<std::string> *log;
+};
+
+int test_dfs_iterative_same_events() {
+    graph::AdjacencyList<graph::tags::Directed> g(6);
+
+    // Contains tree, back, forward and cross edges
+    addEdge(0, 1, g);
+    addEdge(1, 2, g);
+    addEdge(2, 0, g);
+    addEdge(0, 2, g);
+    addEdge(3, 1, g);
+    addEdge(3, 4, g);
+    addEdge(4, 5, g);
+    addEdge(5, 3, g);
+
+    std::vector<std::string> recursive, iterative;
+    graph::dfs(g, RecordingVisitor(&recursive), graph::tags::DFSRecursive());
+    graph::dfs(g, RecordingVisitor(&iterative), graph::tags::DFSIterative());
+    assert(!recursive.empty());
+    assert(recursive == iterative);
+
+    return 0;
+}
+
+int test_topo_sort_long_chain() {
+    // A path this long overflows the call stack with one frame per tree edge
+    const std::size_t n = 1000000;
+    std::vector<std::pair<std::size_t, std::size_t>> el;
+    for (std::size_t i = 0; i + 1 < n; ++i)
+        el.emplace_back(i, i + 1);
+    graph::CompressedGraph<graph::tags::Directed> g(n, el.begin(), el.end());
+
+    std::vector<vertex> order(n);
+    topoSort(g, order.begin());
+    for (std::size_t i = 0; i < n; ++i)
+        assert(order[i] == n - 1 - i);
+
+    return 0;
+}
+
+int test_degrees() {
+    graph::AdjacencyList<graph::tags::Directed> d(4);
+    graph::AdjacencyList<graph::tags::Bidirectional> b(4);
+    graph::AdjacencyList<graph::tags::Undirected> u(4);
+
+    std::vector<std::pair<std::size_t, std::size_t>> el = {{0, 1}, {0, 2}, {0, 3}, {2, 1}};
+    for (auto [src, tar] : el)
+    {
+        addEdge(src, tar, d);
+        addEdge(src, tar, b);
+        addEdge(src, tar, u);
+    }
+
+    assert(outDegree(0, d) == 3 && outDegree(1, d) == 0 && outDegree(2, d) == 1);
+    assert(inDegree(1, d) == 2 && inDegree(0, d) == 0);
+    assert(outDegree(0, b) == 3 && outDegree(2, b) == 1);
+    assert(inDegree(1, b) == 2 && inDegree(3, b) == 1 && inDegree(0, b) == 0);
+    assert(outDegree(0, u) == 3 && outDegree(1, u) == 2 && outDegree(2, u) == 2);
+    assert(inDegree(1, u) == 2);
+
+    // The degree equals the length of the out-edge range
+    for (auto v : vertices(b))
+    {
+        auto oe = outEdges(v, b);
+        assert(outDegree(v, b) == static_cast<std::size_t>(std::distance(oe.begin(), oe.end())));
+        auto ie = inEdges(v, b);
+        assert(inDegree(v, b) == static_cast<std::size_t>(std::distance(ie.begin(), ie.end())));
+    }
+
+    assert((graph::degreeHistogram(d) == std::vector<std::size_t>{2, 1, 0, 1}));
+    assert((graph::inDegreeHistogram(b) == std::vector<std::size_t>{1, 2, 1}));
+    assert((graph::degreeHistogram(u) == std::vector<std::size_t>{0, 1, 2, 1}));
+    assert(graph::degreeHistogram(graph::AdjacencyList<graph::tags::Directed>()).empty());
+
+    // Large enough to be split over several blocks
+    const std::size_t n = 100000;
+    std::vector<std::pair<std::size_t, std::size_t>> star;
+    for (std::size_t i = 1; i < n; ++i)
+        star.emplace_back(0, i);
+    graph::CompressedGraph<graph::tags::Undirected> s(n, star.begin(), star.end());
+    auto h = graph::degreeHistogram(s);
+    assert(h.size() == n && h[1] == n - 1 && h[n - 1] == 1);
+
+    return 0;
+}
+
+int test_edge_lookup() {
+    using Indexed = graph::AdjacencyList<graph::tags::Directed, graph::NoProp, graph::NoProp, graph::HashEdgeIndex<>>;
+    Indexed g(100);
+    graph::AdjacencyList<graph::tags::Directed> plain(100);
+
+    // Enough edges to make the index grow several times
+    for (std::size_t u = 0; u < 100; ++u)
+        for (std::size_t v = 0; v < 100; v += 3)
+            if (u != v)
+            {
+                auto e = addEdge(u, v, g);
+                addEdge(u, v, plain);
+                assert(edge(u, v, g) == e);
+            }
+
+    for (std::size_t u = 0; u < 100; ++u)
+        for (std::size_t v = 0; v < 100; ++v)
+        {
+            auto e = edge(u, v, g);
+            assert(e.has_value() == (u != v && v % 3 == 0));
+            assert(edge(u, v, plain).has_value() == e.has_value());
+            if (e)
+            {
+                assert(source(*e, g) == u && target(*e, g) == v);
+                assert(edge(u, v, plain)->storedEdgeIdx == e->storedEdgeIdx);
+            }
+        }
+
+    // Duplicates are rejected, returning the existing edge
+    const std::size_t m = numEdges(g);
+    auto e = addEdge(1, 3, g);
+    assert(numEdges(g) == m);
+    assert(e == *edge(1, 3, g));
+    assert(outDegree(1, g) == 34);
+
+    // Undirected edges are found in both orientations
+    graph::AdjacencyList<graph::tags::Undirected, graph::NoProp, graph::NoProp, graph::HashEdgeIndex<>> ug(3);
+    auto f = addEdge(2, 0, ug);
+    assert(edge(0, 2, ug) == f && edge(2, 0, ug) == f);
+    assert(!edge(0, 1, ug));
+    addEdge(0, 2, ug);
+    assert(numEdges(ug) == 1);
+
+    return 0;
+}
+
+// Returns the message of the std::runtime_error thrown by f, or the empty string
+template <typename F>
+std::string error_message(F f) {
+    try {
+        f();
+    } catch (const std::runtime_error &e) {
+        return e.what();
+    }
+    return "";
+}
+
+int test_load_dimacs_buffer() {
+    using Graph = graph::AdjacencyList<graph::tags::Directed>;
+    std::string text = "p edge 5 6\ne 1 2\ne 2 3\ne 3 4\ne 4 5\ne 5 1\ne 1 3\n";
+
+    // Tiny blocks, so the text is parsed in many line-aligned pieces
+    for (std::size_t blockSize : {1, 3, 7, 1 << 20})
+    {
+        std::istringstream in(text);
+        Graph expected = graph::loadDimacs<Graph>(in);
+        Graph g = graph::loadDimacs<Graph>(text.data(), text.data() + text.size(), blockSize);
+        assert(numVertices(g) == 5 && numEdges(g) == 6);
+        for (auto u : vertices(g))
+            for (auto v : vertices(g))
+                assert(edge(u, v, g).has_value() == edge(u, v, expected).has_value());
+    }
+
+    // The same errors are reported as by the stream loader
+    std::vector<std::string> malformed = {
+        "",
+        "q edge 1 0\n",
+        "p vertex 1 0\n",
+        "p edge x 0\n",
+        "p edge 3\n",
+        "p edge 3 2\ne 1 2\n",
+        "p edge 3 2\ne 1 2\nf 2 3\n",
+        "p edge 3 2\ne 1 2\ne 2\n",
+        "p edge 3 2\ne 1 2\ne 0 1\n",
+        "p edge 3 2\ne 1 2\ne 1 4\n",
+        "p edge 3 3\ne 1 2\ne 2 3\ne 1 7\n",
+        "p edge 5 99999999999999\ne 1 2\n",
+    };
+    for (const auto &bad : malformed)
+        for (std::size_t blockSize : {1, 1 << 20})
+        {
+            std::istringstream in(bad);
+            std::string expected = error_message([&] { graph::loadDimacs<Graph>(in); });
+            std::string actual = error_message([&] {
+                graph::loadDimacs<Graph>(bad.data(), bad.data() + bad.size(), blockSize);
+            });
+            assert(!expected.empty());
+            assert(expected == actual);
+        }
+
+    // Lines after the m edges are ignored, as by the stream loader
+    std::string trailing = "p edge 2 1\ne 1 2\ngarbage\n";
+    assert(numEdges(graph::loadDimacs<Graph>(trailing.data(), trailing.data() + trailing.size(), 1)) == 1);
+
+    return 0;
+}
+
+int test_load_dimacs_file() {
+    const std::string path = "test/load_dimacs_file.tmp";
+    {
+        std::ofstream out(path);
+        out << "p edge 4 3\ne 1 2\ne 2 3\ne 4 3\n";
+    }
+    auto g = graph::loadDimacsFile<graph::CompressedGraph<graph::tags::Bidirectional>>(path);
+    assert(numVertices(g) == 4 && numEdges(g) == 3);
+    assert(inDegree(2, g) == 2);
+    std::remove(path.c_str());
+
+    assert(!error_message([&] { graph::loadDimacsFile<graph::AdjacencyList<graph::tags::Directed>>(path); }).empty());
+
+    return 0;
+}
+
+struct Weight {
+    double w;
+    int id;
+};
+
+int test_binary_snapshot() {
+    const std::string path = "test/binary_snapshot.tmp";
+
+    // A bidirectional adjacency list with POD properties
+    graph::AdjacencyList<graph::tags::Bidirectional, int, Weight> g;
+    for (int i = 0; i < 5; ++i)
+        addVertex(10 * i, g);
+    addEdge(0, 1, Weight{0.5, 1}, g);
+    addEdge(1, 2, Weight{1.5, 2}, g);
+    addEdge(3, 1, Weight{2.5, 3}, g);
+    addEdge(4, 0, Weight{3.5, 4}, g);
+    graph::saveBinary(g, path);
+
+    auto view = graph::openBinary<graph::tags::Bidirectional, int, Weight>(path);
+    assert(numVertices(view) == 5 && numEdges(view) == 4);
+    assert(inDegree(1, view) == 2 && outDegree(1, view) == 1);
+    for (auto v : vertices(view))
+        assert(view[v] == g[v]);
+    for (auto e : edges(view))
+    {
+        auto orig = edge(source(e, view), target(e, view), g);
+        assert(orig && view[e].w == g[*orig].w && view[e].id == g[*orig].id);
+    }
+    for (auto e : inEdges(1, view))
+        assert(view[e].id == 1 || view[e].id == 3);
+
+    // Copies share the mapping, which outlives the original view
+    auto copy = view;
+    view = decltype(view)();
+    std::remove(path.c_str());
+    std::vector<vertex> order(numVertices(copy));
+    topoSort(copy, order.begin());
+    assert(order.front() == 2);
+
+    // Adjacency matrices are saved through their compressed form
+    graph::AdjacencyMatrix am(3);
+    addEdge(0, 2, am);
+    addEdge(2, 1, am);
+    graph::saveBinary(am, path);
+    auto amView = graph::openBinary<graph::tags::Directed>(path);
+    assert(numEdges(amView) == 2 && outDegree(0, amView) == 1 && outDegree(2, amView) == 1);
+
+    // Truncated files and corrupt headers are rejected on every open, corrupt index arrays
+    // only by a full check, which is opt-in as it reads them all
+    graph::saveBinary(g, path);
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    graph::detail::BinaryHeader h;
+    std::memcpy(&h, bytes.data(), sizeof(h));
+    const graph::detail::BinaryLayout layout(h);
+    using L = graph::detail::BinaryLayout;
+    auto corrupt_error = [&](std::size_t length, std::size_t offset, std::uint64_t value, graph::BinaryCheck check) {
+        std::string b = bytes.substr(0, length);
+        if (offset + sizeof(value) <= b.size())
+            std::memcpy(b.data() + offset, &value, sizeof(value));
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(b.data(), b.size());
+        }
+        return error_message([&] { graph::openBinary<graph::tags::Bidirectional, int, Weight>(path, check); });
+    };
+    const std::size_t all = bytes.size(), none = all;
+    for (auto check : {graph::BinaryCheck::Header, graph::BinaryCheck::Full})
+    {
+        assert(corrupt_error(all, none, 0, check).empty());
+        assert(corrupt_error(all - 1, none, 0, check).find("truncated") != std::string::npos);
+        assert(corrupt_error(all, offsetof(graph::detail::BinaryHeader, n), std::uint64_t(1) << 61, check).find("Corrupt header") != std::string::npos);
+        assert(corrupt_error(all, offsetof(graph::detail::BinaryHeader, n), ~std::uint64_t(0), check).find("Corrupt header") != std::string::npos);
+        assert(corrupt_error(all, offsetof(graph::detail::BinaryHeader, m), 3, check).find("Edge count") != std::string::npos);
+        assert(corrupt_error(all, layout.offset[L::Offsets] + 8 * 5, 3, check).find("Corrupt offsets") != std::string::npos);
+    }
+    const std::vector<std::tuple<std::size_t, std::uint64_t, std::string>> corruptArrays = {
+        {layout.offset[L::Offsets] + 8, 3, "Corrupt offsets"},
+        {layout.offset[L::Targets], 5, "Target out of bounds"},
+        {layout.offset[L::InOffsets] + 16, 9, "Corrupt in-offsets"},
+        {layout.offset[L::InSources], 7, "Source out of bounds"},
+        {layout.offset[L::InEdgeIds], 4, "In-edge entry"},
+    };
+    for (const auto &[offset, value, message] : corruptArrays)
+    {
+        assert(corrupt_error(all, offset, value, graph::BinaryCheck::Header).empty());
+        assert(corrupt_error(all, offset, value, graph::BinaryCheck::Full).find(message) != std::string::npos);
+    }
+    std::remove(path.c_str());
+
+    // Mismatching types and foreign files are rejected
+    assert(!error_message([&] { graph::openBinary<graph::tags::Undirected>(path); }).empty());
+    assert(!error_message([&] { graph::openBinary<graph::tags::Directed, int>(path); }).empty());
+    std::remove(path.c_str());
+    {
+        std::ofstream out(path);
+        out << "p edge 1 0\n";
+    }
+    assert(!error_message([&] { graph::openBinary<graph::tags::Directed>(path); }).empty());
+    std::remove(path.c_str());
+
+    return 0;
+}
+
+int test_adjacency_matrix_bits() {
+    static_assert(graph::VertexListGraph<graph::AdjacencyMatrix>);
+    static_assert(graph::EdgeListGraph<graph::AdjacencyMatrix>);
+    static_assert(graph::IncidenceGraph<graph::AdjacencyMatrix>);
+
+    // Rows span several words, with a partial last word
+    const std::size_t n = 130;
+    graph::AdjacencyMatrix g(n);
+    std::vector<std::pair<std::size_t, std::size_t>> expected;
+    for (std::size_t u = 0; u < n; ++u)
+        for (std::size_t v = 0; v < n; ++v)
+            if ((u * 7 + v * 13) % 23 == 0 || (u == 5 && (v == 0 || v == 63 || v == 64 || v == 129)))
+            {
+                addEdge(u, v, g);
+                expected.emplace_back(u, v);
+            }
+    assert(numEdges(g) == expected.size());
+
+    std::vector<std::pair<std::size_t, std::size_t>> actual;
+    for (auto e : edges(g))
+    {
+        assert(e.exists);
+        actual.emplace_back(source(e, g), target(e, g));
+    }
+    assert(actual == expected);
+
+    for (auto u : vertices(g))
+    {
+        std::size_t d = 0;
+        for (auto e : outEdges(u, g))
+        {
+            assert(source(e, g) == u);
+            ++d;
+        }
+        assert(outDegree(u, g) == d);
+    }
+
+    // Rows without any edges are skipped
+    graph::AdjacencyMatrix sparse(200);
+    addEdge(199, 0, sparse);
+    addEdge(0, 199, sparse);
+    actual.clear();
+    for (auto e : edges(sparse))
+        actual.emplace_back(source(e, sparse), target(e, sparse));
+    assert((actual == std::vector<std::pair<std::size_t, std::size_t>>{{0, 199}, {199, 0}}));
+    assert(outDegree(100, sparse) == 0 && outDegree(199, sparse) == 1);
+
+    graph::AdjacencyMatrix empty(0);
+    assert(edges(empty).begin() == edges(empty).end());
+
+    return 0;
+}
+
+// Checks that g and h have the same edges, with the same indices and list orders
+template <typename G, typename H>
+void assert_same_adjacency(const G &g, const H &h) {
+    assert(numVertices(g) == numVertices(h) && numEdges(g) == numEdges(h));
+    auto ge = edges(g), he = edges(h);
+    assert(std::equal(ge.begin(), ge.end(), he.begin(), he.end(), [&](auto a, auto b) {
+        return source(a, g) == source(b, h) && target(a, g) == target(b, h);
+    }));
+    // descriptors of different graph types are not comparable
+    auto same = [&](auto a, auto b) {
+        if constexpr (std::is_same_v<G, H>)
+            if (!(a == b))
+                return false;
+        return source(a, g) == source(b, h) && target(a, g) == target(b, h);
+    };
+    for (auto v : vertices(g))
+    {
+        auto go = outEdges(v, g), ho = outEdges(v, h);
+        assert(std::equal(go.begin(), go.end(), ho.begin(), ho.end(), same));
+        if constexpr (std::is_same_v<typename G::DirectedCategory, graph::tags::Bidirectional>)
+        {
+            auto gi = inEdges(v, g), hi = inEdges(v, h);
+            assert(std::equal(gi.begin(), gi.end(), hi.begin(), hi.end(), same));
+        }
+    }
+}
+
+template <typename Category, typename Graph = graph::AdjacencyList<Category>>
+void check_bulk_insertion() {
+    std::vector<std::pair<std::size_t, std::size_t>> el;
+    for (std::size_t u = 0; u < 50; ++u)
+        for (std::size_t v = u + 1; v < 50; v += u % 4 + 1)
+            el.emplace_back((u * 31) % 50, (v * 31) % 50);
+
+    Graph sequential(50);
+    for (auto [u, v] : el)
+        addEdge(u, v, sequential);
+
+    Graph bulk(50, el.begin(), el.end());
+    assert_same_adjacency(sequential, bulk);
+
+    // Adding to a graph that already has edges
+    Graph mixed(50);
+    auto mid = el.begin() + el.size() / 3;
+    for (auto it = el.begin(); it != mid; ++it)
+        addEdge(it->first, it->second, mixed);
+    addEdges(mid, el.end(), mixed);
+    assert_same_adjacency(sequential, mixed);
+}
+
+int test_bulk_insertion() {
+    check_bulk_insertion<graph::tags::Directed>();
+    check_bulk_insertion<graph::tags::Bidirectional>();
+    check_bulk_insertion<graph::tags::Undirected>();
+    check_bulk_insertion<graph::tags::Directed, graph::ArenaAdjacencyList<graph::tags::Directed>>();
+    check_bulk_insertion<graph::tags::Bidirectional, graph::ArenaAdjacencyList<graph::tags::Bidirectional>>();
+    check_bulk_insertion<graph::tags::Undirected, graph::ArenaAdjacencyList<graph::tags::Undirected>>();
+
+    // With an edge index duplicates in the batch are skipped
+    using Indexed = graph::AdjacencyList<graph::tags::Bidirectional, graph::NoProp, graph::NoProp, graph::HashEdgeIndex<>>;
+    std::vector<std::pair<std::size_t, std::size_t>> el = {{0, 1}, {1, 2}, {0, 1}, {2, 0}, {1, 2}};
+    Indexed g(3, el.begin(), el.end());
+    assert(numEdges(g) == 3 && inDegree(1, g) == 1 && outDegree(1, g) == 1);
+    addEdges(el.begin(), el.end(), g);
+    assert(numEdges(g) == 3);
+    assert(edge(2, 0, g) && edge(2, 0, g)->storedEdgeIdx == 2);
+
+    return 0;
+}
+
+int test_compact_indices() {
+    using Compact = graph::CompactAdjacencyList<graph::tags::Bidirectional>;
+    using Wide = graph::AdjacencyList<graph::tags::Bidirectional>;
+    static_assert(std::is_same_v<Compact::VertexDescriptor, std::uint32_t>);
+    static_assert(sizeof(Compact::EdgeDescriptor) == 3 * sizeof(std::uint32_t));
+    static_assert(graph::VertexListGraph<Compact> && graph::EdgeListGraph<Compact>);
+    static_assert(graph::BidirectionalGraph<Compact> && graph::MutableGraph<Compact>);
+
+    std::vector<std::pair<std::size_t, std::size_t>> el = {{0, 3}, {3, 1}, {1, 2}, {0, 2}, {4, 0}};
+    Compact c(5, el.begin(), el.end());
+    Wide w(5, el.begin(), el.end());
+    auto v = addVertex(c);
+    addEdge(v, 4, c);
+    addEdge(addVertex(w), 4, w);
+
+    assert(numEdges(c) == numEdges(w) && inDegree(4, c) == 1);
+    std::vector<Compact::VertexDescriptor> co(numVertices(c));
+    std::vector<Wide::VertexDescriptor> wo(numVertices(w));
+    topoSort(c, co.begin());
+    topoSort(w, wo.begin());
+    assert(std::equal(co.begin(), co.end(), wo.begin(), wo.end()));
+
+    std::string text = "p edge 3 2\ne 1 2\ne 3 2\n";
+    auto d = graph::loadDimacs<graph::CompactAdjacencyList<graph::tags::Directed, graph::NoProp, graph::NoProp, graph::HashEdgeIndex<>>>(
+        text.data(), text.data() + text.size());
+    assert(edge(2, 1, d) && !edge(1, 2, d));
+    // the index of a compact graph keys and maps its edges by 32-bit indices
+    static_assert(std::is_same_v<decltype(d)::EdgeIndex, graph::HashEdgeIndex<std::uint32_t>>);
+    graph::HashEdgeIndex<std::uint8_t> small;
+    assert(small.insert(254, 3, 254).second && !small.insert(254, 3, 0).second);
+    assert(small.find(254, 3) == 254u && !small.find(3, 254));
+
+    return 0;
+}
+
+int test_parallel_topo_sort() {
+    // A wide DAG: 3 layers, every vertex of a layer points to every vertex of the next
+    std::vector<std::pair<std::size_t, std::size_t>> el;
+    const std::size_t width = 40;
+    for (std::size_t layer = 0; layer + 1 < 3; ++layer)
+        for (std::size_t i = 0; i < width; ++i)
+            for (std::size_t j = 0; j < width; ++j)
+                el.emplace_back(layer * width + i, (layer + 1) * width + j);
+    // and a shortcut from the first to the last layer, which must not lower the level
+    el.emplace_back(0, 2 * width + 1);
+    graph::CompressedGraph<graph::tags::Directed> g(3 * width, el.begin(), el.end());
+
+    std::vector<vertex> order;
+    std::vector<std::size_t> level;
+    assert(graph::parallelTopoSort(g, std::back_inserter(order), level));
+    assert(order.size() == numVertices(g));
+    std::vector<std::size_t> position(numVertices(g));
+    for (std::size_t i = 0; i < order.size(); ++i)
+        position[order[i]] = i;
+    for (auto e : edges(g))
+    {
+        assert(position[source(e, g)] < position[target(e, g)]);
+        assert(level[source(e, g)] < level[target(e, g)]);
+    }
+    for (auto v : vertices(g))
+        assert(level[v] == v / width);
+
+    // Frontiers large enough to be split: the same order for any number of threads,
+    // each level sorted by index
+    const std::size_t n = 200000;
+    const graph::CompressedGraph<graph::tags::Directed> dag(
+        graph::buildGraph<graph::CompressedGraph<graph::tags::Directed>>(n, graph::randomDagEdges(n, 2 * n, 3)));
+    graph::ThreadPool serial(0), pool(3);
+    std::vector<std::size_t> dagOrder, serialOrder, serialLevel;
+    assert(graph::parallelTopoSort(dag, std::back_inserter(dagOrder), level, pool));
+    assert(graph::parallelTopoSort(dag, std::back_inserter(serialOrder), serialLevel, serial));
+    assert(dagOrder == serialOrder && level == serialLevel);
+    for (std::size_t k = 1; k < n; ++k)
+        assert(level[dagOrder[k - 1]] < level[dagOrder[k]] || dagOrder[k - 1] < dagOrder[k]);
+
+    // Sorted runs of uneven lengths, some empty, merged into one
+    std::vector<std::size_t> runs = {7, 3, 1, 4, 2, 9, 8, 6, 0, 5};
+    std::vector<std::size_t> expected(runs.begin() + 1, runs.end());
+    std::sort(expected.begin(), expected.end());
+    std::sort(runs.begin() + 1, runs.begin() + 5);
+    std::sort(runs.begin() + 5, runs.begin() + 6);
+    std::sort(runs.begin() + 6, runs.end());
+    graph::detail::mergeRuns(runs, {1, 5, 5, 6, 10, 10}, pool);
+    assert(runs.front() == 7 && std::equal(runs.begin() + 1, runs.end(), expected.begin(), expected.end()));
+
+    // A cycle 1 -> 2 -> 3 -> 1 with a tail 3 -> 4, reached from the source 0
+    graph::AdjacencyList<graph::tags::Directed> c(5);
+    addEdge(0, 1, c);
+    addEdge(1, 2, c);
+    addEdge(2, 3, c);
+    addEdge(3, 1, c);
+    addEdge(3, 4, c);
+    order.clear();
+    assert(!graph::parallelTopoSort(c, std::back_inserter(order), level));
+    assert(order.empty());
+    assert(level[0] == 0);
+    for (std::size_t v = 1; v < 5; ++v)
+        assert(level[v] == graph::noLevel);
+
+    return 0;
+}
+
+struct BFSRecordingVisitor : graph::BFSNullVisitor {
+    std::vector<std::string> *log;
+
+    template <typename G, typename V>
+    void discoverVertex(const V &v, const G &) { log->push_back("discover " + std::to_string(v)); }
+
+    template <typename G, typename V>
+    void finishVertex(const V &v, const G &) { log->push_back("finish " + std::to_string(v)); }
+
+    template <typename G, typename E>
+    void treeEdge(const E &e, const G &g) { log->push_back("tree " + std::to_string(target(e, g))); }
+
+    template <typename G, typename E>
+    void greyTarget(const E &e, const G &g) { log->push_back("grey " + std::to_string(target(e, g))); }
+
+    template <typename G, typename E>
+    void blackTarget(const E &e, const G &g) { log->push_back("black " + std::to_string(target(e, g))); }
+};
+
+template <typename G>
+struct BFSDistanceVisitor : graph::BFSNullVisitor {
+    std::vector<std::size_t> *distance;
+
+    template <typename E>
+    void treeEdge(const E &e, const G &g) {
+        (*distance)[getIndex(target(e, g), g)] = (*distance)[getIndex(source(e, g), g)] + 1;
+    }
+};
+
+template <typename G>
+void check_parallel_bfs(const G &g, typename graph::Traits<G>::VertexDescriptor s) {
+    std::vector<std::size_t> expected(numVertices(g), graph::unreachable);
+    expected[getIndex(s, g)] = 0;
+    graph::bfs(g, s, BFSDistanceVisitor<G>{{}, &expected});
+
+    std::vector<std::size_t> distance, parent;
+    graph::parallelBfs(g, s, distance, parent);
+    assert(distance == expected);
+    assert(parent[getIndex(s, g)] == getIndex(s, g));
+    for (auto v : vertices(g))
+    {
+        const std::size_t i = getIndex(v, g);
+        if (distance[i] == graph::unreachable || i == getIndex(s, g))
+        {
+            assert(i == getIndex(s, g) || parent[i] == graph::unreachable);
+            continue;
+        }
+        // the parent is one level closer and has an edge to v
+        assert(distance[parent[i]] + 1 == distance[i]);
+        bool hasEdge = false;
+        for (auto e : outEdges(parent[i], g))
+            hasEdge = hasEdge || getIndex(target(e, g), g) == i;
+        assert(hasEdge);
+    }
+}
+
+int test_bfs() {
+    // 0 -> 1, 0 -> 2, 1 -> 3, 2 -> 3, 3 -> 0, 4 unreachable
+    graph::AdjacencyList<graph::tags::Directed> g(5);
+    addEdge(0, 1, g);
+    addEdge(0, 2, g);
+    addEdge(1, 3, g);
+    addEdge(2, 3, g);
+    addEdge(3, 0, g);
+    std::vector<std::string> log;
+    graph::bfs(g, 0, BFSRecordingVisitor{{}, &log});
+    const std::vector<std::string> expected{
+        "discover 0", "tree 1", "discover 1", "tree 2", "discover 2", "finish 0",
+        "tree 3", "discover 3", "finish 1", "grey 3", "finish 2", "black 0", "finish 3"};
+    assert(log == expected);
+
+    // A low-diameter graph: hubs joined to everything and a few chords per vertex,
+    // plus a long path hanging off it, so both top-down and bottom-up steps are taken
+    std::vector<std::pair<std::size_t, std::size_t>> el;
+    const std::size_t n = 20000, path = 3000;
+    for (std::size_t v = 10; v < n - path; ++v)
+    {
+        el.emplace_back(v % 10, v);
+        for (std::size_t k : {7919, 104729, 1299709, 15485863})
+            if (const std::size_t t = (v * k) % (n - path); t >= 10 && t != v)
+                el.emplace_back(std::min(v, t), std::max(v, t));
+    }
+    // no loops or parallel edges, also when read as undirected
+    std::sort(el.begin(), el.end());
+    el.erase(std::unique(el.begin(), el.end()), el.end());
+    for (std::size_t v = n - path; v < n; ++v)
+        el.emplace_back(v - 1, v);
+    el.emplace_back(n - path / 2, 5);
+
+    check_parallel_bfs(graph::CompressedGraph<graph::tags::Directed>(n, el.begin(), el.end()), 0);
+    check_parallel_bfs(graph::CompressedGraph<graph::tags::Bidirectional>(n, el.begin(), el.end()), 0);
+    check_parallel_bfs(graph::CompressedGraph<graph::tags::Undirected>(n, el.begin(), el.end()), 0);
+    check_parallel_bfs(graph::CompressedGraph<graph::tags::Undirected>(n, el.begin(), el.end()), n - 1);
+    check_parallel_bfs(graph::AdjacencyList<graph::tags::Bidirectional>(n, el.begin(), el.end()), 17);
+    check_parallel_bfs(g, 3);
+    check_parallel_bfs(g, 4);
+
+    return 0;
+}
+
+// Sums [first, last) by splitting it in halves as nested tasks
+std::size_t nested_sum(graph::ThreadPool &pool, std::size_t first, std::size_t last) {
+    if (last - first <= 64)
+    {
+        std::size_t sum = 0;
+        for (std::size_t i = first; i < last; ++i)
+            sum += i;
+        return sum;
+    }
+    const std::size_t mid = first + (last - first) / 2;
+    std::size_t left = 0;
+    graph::TaskGroup group(pool);
+    group.run([&] { left = nested_sum(pool, first, mid); });
+    const std::size_t right = nested_sum(pool, mid, last);
+    group.wait();
+    return left + right;
+}
+
+int test_thread_pool() {
+    for (std::size_t workers : {0, 1, 3})
+    {
+        graph::ThreadPool pool(workers);
+        assert(pool.numThreads() == workers + 1);
+        assert(nested_sum(pool, 0, 100000) == std::size_t(100000) * 99999 / 2);
+
+        // nested parallel loops on the same pool
+        std::atomic<std::size_t> count{0};
+        graph::parallelFor(0, 64, [&](std::size_t) {
+            graph::parallelFor(0, 100, [&](std::size_t) { ++count; }, 1, pool);
+        }, 1, pool);
+        assert(count == 6400);
+
+        // the first exception of a task is rethrown, after the other tasks are done
+        count = 0;
+        assert(error_message([&] {
+            graph::parallelBlocks(0, 100, 1, [&](std::size_t, std::size_t first, std::size_t last) {
+                ++count;
+                if (first <= 42 && 42 < last)
+                    throw std::runtime_error("block of 42");
+            }, pool);
+        }) == "block of 42");
+        assert(count == graph::numBlocks(100, 1, pool));
+
+        // concurrent queries from outside threads sharing the pool
+        std::vector<std::pair<std::size_t, std::size_t>> el;
+        for (std::size_t v = 1; v < 5000; ++v)
+            el.emplace_back(v / 2, v);
+        graph::AdjacencyList<graph::tags::Bidirectional> g(5000, el.begin(), el.end(), pool);
+        std::vector<std::thread> clients;
+        for (std::size_t c = 0; c < 3; ++c)
+            clients.emplace_back([&] {
+                std::vector<std::size_t> distance;
+                graph::parallelBfs(g, 0, distance, pool);
+                assert(distance[4999] == 13);
+                assert(graph::degreeHistogram(g, pool) == (std::vector<std::size_t>{2500, 1, 2499}));
+                std::vector<vertex> order;
+                std::vector<std::size_t> level;
+                assert(graph::parallelTopoSort(g, std::back_inserter(order), level, pool));
+            });
+        for (auto &c : clients)
+            c.join();
+
+        std::vector<std::atomic<int>> seen(numVertices(g));
+        graph::parallelForVertices(g, [&](vertex v) { ++seen[v]; }, 100, pool);
+        for (const auto &s : seen)
+            assert(s == 1);
+    }
+    return 0;
+}
+
+// Checks distances and parents of a shortest path search against Bellman-Ford
+template <typename G, typename W, typename WeightMap>
+void check_shortest_paths(const G &g, std::size_t s, const std::vector<W> &distance,
+                          const std::vector<std::size_t> &parent, WeightMap weight) {
+    std::vector<W> expected(numVertices(g), graph::infiniteDistance<W>);
+    expected[s] = 0;
+    for (bool changed = true; changed;)
+    {
+        changed = false;
+        for (auto e : edges(g))
+        {
+            const W d = expected[source(e, g)];
+            if (d != graph::infiniteDistance<W> && d + weight(e, g) < expected[target(e, g)])
+            {
+                expected[target(e, g)] = d + weight(e, g);
+                changed = true;
+            }
+        }
+    }
+    assert(distance == expected);
+    assert(parent[s] == s);
+    for (auto v : vertices(g))
+    {
+        if (v == s)
+            continue;
+        if (distance[v] == graph::infiniteDistance<W>)
+        {
+            assert(parent[v] == graph::unreachable);
+            continue;
+        }
+        // the parent edge is on a shortest path, and following parents leads to s
+        bool tight = false;
+        for (auto e : outEdges(parent[v], g))
+            tight = tight || (target(e, g) == v && distance[parent[v]] + weight(e, g) == distance[v]);
+        assert(tight);
+        std::size_t u = v, steps = 0;
+        for (; u != s && steps <= numVertices(g); ++steps)
+            u = parent[u];
+        assert(u == s);
+    }
+}
+
+// Shows only the out-edges and vertex indices of a graph, without vertex or edge lists
+template <typename G>
+struct IncidenceView {
+    using VertexDescriptor = typename graph::Traits<G>::VertexDescriptor;
+    using EdgeDescriptor = typename graph::Traits<G>::EdgeDescriptor;
+    using DirectedCategory = typename graph::Traits<G>::DirectedCategory;
+    using OutEdgeRange = typename graph::Traits<G>::OutEdgeRange;
+
+    const G *g;
+
+    decltype(auto) operator[](const EdgeDescriptor &e) const { return (*g)[e]; }
+
+    friend OutEdgeRange outEdges(const VertexDescriptor &v, const IncidenceView &h) { return outEdges(v, *h.g); }
+    friend std::size_t outDegree(const VertexDescriptor &v, const IncidenceView &h) { return outDegree(v, *h.g); }
+    friend VertexDescriptor source(const EdgeDescriptor &e, const IncidenceView &h) { return source(e, *h.g); }
+    friend VertexDescriptor target(const EdgeDescriptor &e, const IncidenceView &h) { return target(e, *h.g); }
+    friend std::size_t getIndex(const VertexDescriptor &v, const IncidenceView &h) { return getIndex(v, *h.g); }
+};
+
+int test_shortest_paths() {
+    // A 60 x 60 grid with pseudo-random integer weights, including zeros,
+    // and a few long shortcuts, with the last row unreachable
+    const std::size_t side = 60;
+    graph::AdjacencyList<graph::tags::Directed, graph::NoProp, unsigned> g(side * side);
+    std::uint64_t seed = 12345;
+    auto next = [&] { return seed = seed * 6364136223846793005ull + 1442695040888963407ull, seed >> 33; };
+    for (std::size_t r = 0; r + 1 < side; ++r)
+        for (std::size_t c = 0; c < side; ++c)
+        {
+            const std::size_t v = r * side + c;
+            if (c + 1 < side)
+            {
+                addEdge(v, v + 1, unsigned(next() % 10), g);
+                addEdge(v + 1, v, unsigned(next() % 10), g);
+            }
+            if (r + 2 < side)
+            {
+                addEdge(v, v + side, unsigned(next() % 10), g);
+                addEdge(v + side, v, unsigned(next() % 10), g);
+            }
+            if (next() % 50 == 0)
+            {
+                const std::size_t t = next() % (side * (side - 1));
+                if (t != v && !edge(v, t, g))
+                    addEdge(v, t, unsigned(next() % 1000), g);
+            }
+        }
+
+    std::vector<unsigned> distance;
+    std::vector<std::size_t> parent;
+    graph::dijkstra(g, 0, distance, parent);
+    check_shortest_paths(g, 0, distance, parent, graph::EdgePropWeight());
+    std::vector<unsigned> heapDistance;
+    graph::dijkstra(g, 0, heapDistance, parent, graph::EdgePropWeight(), graph::tags::DAryHeap());
+    assert(heapDistance == distance);
+    check_shortest_paths(g, 0, heapDistance, parent, graph::EdgePropWeight());
+    graph::ThreadPool pool(3);
+    for (unsigned delta : {0u, 1u, 7u, 100u})
+    {
+        std::vector<unsigned> parallelDistance;
+        graph::deltaStepping(g, 0, parallelDistance, parent, graph::EdgePropWeight(), delta, pool);
+        check_shortest_paths(g, 0, parallelDistance, parent, graph::EdgePropWeight());
+    }
+
+    // Only out-edges and indices, with room for more vertices than the graph has
+    const IncidenceView<decltype(g)> incidence{&g};
+    static_assert(!graph::VertexListGraph<decltype(incidence)>);
+    std::vector<unsigned> incidenceDistance;
+    graph::deltaStepping(incidence, 0, numVertices(g) + 5, incidenceDistance, parent, graph::EdgePropWeight(), 0u, pool);
+    assert(incidenceDistance.size() == numVertices(g) + 5 && parent.size() == numVertices(g) + 5);
+    incidenceDistance.resize(numVertices(g));
+    assert(incidenceDistance == distance);
+
+    // Floating-point weights read from a member of the edge property
+    graph::AdjacencyList<graph::tags::Directed, graph::NoProp, Weight> wg(side * side);
+    for (auto e : edges(g))
+        addEdge(source(e, g), target(e, g), Weight{g[e] / 4.0, 0}, wg);
+    const graph::CompressedGraph<graph::tags::Directed, graph::NoProp, Weight> cg(wg);
+    auto byMember = [](auto e, const auto &h) { return h[e].w; };
+    std::vector<double> realDistance;
+    graph::dijkstra(cg, 17, realDistance, parent, byMember);
+    check_shortest_paths(cg, 17, realDistance, parent, byMember);
+    graph::deltaStepping(cg, 17, realDistance, parent, byMember);
+    check_shortest_paths(cg, 17, realDistance, parent, byMember);
+
+    return 0;
+}
+
+// Shows only the vertex and edge lists of a graph, without out-edges
+template <typename G>
+struct EdgeListView {
+    using VertexDescriptor = typename graph::Traits<G>::VertexDescriptor;
+    using EdgeDescriptor = typename graph::Traits<G>::EdgeDescriptor;
+    using DirectedCategory = typename graph::Traits<G>::DirectedCategory;
+    using VertexRange = typename graph::Traits<G>::VertexRange;
+    using EdgeRange = typename graph::Traits<G>::EdgeRange;
+
+    const G *g;
+
+    friend VertexRange vertices(const EdgeListView &h) { return vertices(*h.g); }
+    friend std::size_t numVertices(const EdgeListView &h) { return numVertices(*h.g); }
+    friend EdgeRange edges(const EdgeListView &h) { return edges(*h.g); }
+    friend std::size_t numEdges(const EdgeListView &h) { return numEdges(*h.g); }
+    friend VertexDescriptor source(const EdgeDescriptor &e, const EdgeListView &h) { return source(e, *h.g); }
+    friend VertexDescriptor target(const EdgeDescriptor &e, const EdgeListView &h) { return target(e, *h.g); }
+    friend std::size_t getIndex(const VertexDescriptor &v, const EdgeListView &h) { return getIndex(v, *h.g); }
+};
+
+// Checks that the labels are those of a sequential union-find, numbered by smallest vertex
+template <typename G>
+void check_components(const G &g, const std::vector<std::size_t> &component, std::size_t count) {
+    std::vector<std::size_t> root(numVertices(g));
+    for (std::size_t i = 0; i < root.size(); ++i)
+        root[i] = i;
+    auto find = [&](std::size_t x) {
+        while (root[x] != x)
+            x = root[x];
+        return x;
+    };
+    for (auto e : edges(g))
+    {
+        const std::size_t a = find(source(e, g)), b = find(target(e, g));
+        root[std::max(a, b)] = std::min(a, b);
+    }
+    std::vector<std::size_t> expected(root.size());
+    std::size_t expectedCount = 0;
+    for (std::size_t i = 0; i < root.size(); ++i)
+        expected[i] = find(i) == i ? expectedCount++ : expected[find(i)];
+    assert(count == expectedCount);
+    assert(component == expected);
+}
+
+int test_connected_components() {
+    // A giant component of long cycles joined by chords, a few small ones, and isolated vertices
+    std::vector<std::pair<std::size_t, std::size_t>> el;
+    const std::size_t n = 30000, giant = 25000;
+    for (std::size_t v = 0; v + 1 < giant; ++v)
+        el.emplace_back(v, v + 1);
+    for (std::size_t v = 0; v < giant; v += 97)
+        el.emplace_back(v, (v * 7919 + 13) % giant);
+    for (std::size_t v = giant; v + 4 < n; v += 5)
+    {
+        el.emplace_back(v + 1, v);
+        el.emplace_back(v + 2, v + 1);
+        el.emplace_back(v + 3, v + 1);
+    }
+    std::erase_if(el, [](const auto &p) { return p.first == p.second; });
+    std::sort(el.begin(), el.end());
+    el.erase(std::unique(el.begin(), el.end()), el.end());
+    // drop chords that repeat an edge in the other direction
+    std::erase_if(el, [&](const auto &p) {
+        return p.first > p.second && std::binary_search(el.begin(), el.end(), std::make_pair(p.second, p.first));
+    });
+
+    graph::ThreadPool pool(3);
+    std::vector<std::size_t> component;
+    const graph::CompressedGraph<graph::tags::Undirected> ug(n, el.begin(), el.end());
+    check_components(ug, component, graph::connectedComponents(ug, component, pool));
+    assert(component[0] == 0 && component[giant - 1] == 0 && component[giant] == 1);
+
+    const graph::AdjacencyList<graph::tags::Directed> dg(n, el.begin(), el.end());
+    check_components(dg, component, graph::connectedComponents(dg, component, pool));
+    check_components(dg, component, graph::connectedComponents(dg, component));
+
+    const EdgeListView<graph::CompressedGraph<graph::tags::Undirected>> view{&ug};
+    static_assert(!graph::IncidenceGraph<decltype(view)> && graph::EdgeListGraph<decltype(view)>);
+    check_components(ug, component, graph::connectedComponents(view, component, pool));
+
+    const graph::AdjacencyList<graph::tags::Undirected> empty;
+    assert(graph::connectedComponents(empty, component) == 0 && component.empty());
+
+    return 0;
+}
+
+// A BFS visitor calling f on every discovered vertex
+template <typename F>
+struct BFSNullVisitorWith : graph::BFSNullVisitor {
+    F f;
+    BFSNullVisitorWith(F f) : f(f) {}
+
+    template <typename G, typename V>
+    void discoverVertex(const V &v, const G &) { f(v); }
+};
+
+// Checks that two labellings describe the same partition
+void assert_same_partition(const std::vector<std::size_t> &a, const std::vector<std::size_t> &b) {
+    assert(a.size() == b.size());
+    std::vector<std::size_t> aToB(a.size() + 1, graph::unreachable), bToA(b.size() + 1, graph::unreachable);
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        if (aToB[a[i]] == graph::unreachable)
+            aToB[a[i]] = b[i];
+        if (bToA[b[i]] == graph::unreachable)
+            bToA[b[i]] = a[i];
+        assert(aToB[a[i]] == b[i] && bToA[b[i]] == a[i]);
+    }
+}
+
+int test_strongly_connected_components() {
+    // A small random graph, checked against mutual reachability
+    std::uint64_t seed = 99;
+    auto next = [&] { return seed = seed * 6364136223846793005ull + 1442695040888963407ull, seed >> 33; };
+    const std::size_t n = 150;
+    std::vector<std::pair<std::size_t, std::size_t>> el;
+    for (std::size_t k = 0; k < 200; ++k)
+        el.emplace_back(next() % n, next() % n);
+    std::erase_if(el, [](const auto &p) { return p.first == p.second; });
+    std::sort(el.begin(), el.end());
+    el.erase(std::unique(el.begin(), el.end()), el.end());
+    const graph::AdjacencyList<graph::tags::Bidirectional> g(n, el.begin(), el.end());
+
+    std::vector<std::size_t> component, parallelComponent;
+    const std::size_t count = graph::stronglyConnectedComponents(g, component);
+    assert(graph::parallelStronglyConnectedComponents(g, parallelComponent) == count);
+    assert_same_partition(component, parallelComponent);
+    std::vector<std::vector<char>> reaches(n, std::vector<char>(n, 0));
+    for (std::size_t u = 0; u < n; ++u)
+    {
+        graph::bfs(g, u, BFSNullVisitorWith([&](auto v) { reaches[u][v] = 1; }));
+    }
+    for (std::size_t u = 0; u < n; ++u)
+        for (std::size_t v = 0; v < n; ++v)
+            assert((component[u] == component[v]) == (reaches[u][v] && reaches[v][u]));
+    // the ids are in reverse topological order
+    for (auto e : edges(g))
+        assert(component[source(e, g)] >= component[target(e, g)]);
+
+    // The condensation is a DAG on which topoSort runs
+    const auto dag = graph::condensation(g, component, count);
+    assert(numVertices(dag) == count);
+    std::vector<vertex> order;
+    graph::topoSort(dag, std::back_inserter(order));
+    assert(order.size() == count);
+    std::vector<std::size_t> level;
+    assert(graph::parallelTopoSort(dag, std::back_inserter(order), level));
+    for (auto e : edges(dag))
+        assert(source(e, dag) != target(e, dag));
+
+    // A long chain of 2-cycles with a DAG tail, too deep for recursion
+    el.clear();
+    const std::size_t pairs = 30000, tail = 20000;
+    for (std::size_t i = 0; i < pairs; ++i)
+    {
+        el.emplace_back(2 * i, 2 * i + 1);
+        el.emplace_back(2 * i + 1, 2 * i);
+        el.emplace_back(2 * i + 1, 2 * i + 2);
+    }
+    for (std::size_t i = 2 * pairs; i + 1 < 2 * pairs + tail; ++i)
+        el.emplace_back(i, i + 1);
+    const graph::CompressedGraph<graph::tags::Bidirectional> chain(2 * pairs + tail, el.begin(), el.end());
+    assert(graph::stronglyConnectedComponents(chain, component) == pairs + tail);
+    graph::ThreadPool pool(3);
+    assert(graph::parallelStronglyConnectedComponents(chain, parallelComponent, pool) == pairs + tail);
+    assert_same_partition(component, parallelComponent);
+    assert(parallelComponent[0] == 0 && parallelComponent[1] == 0 && parallelComponent[2] == 1);
+
+    return 0;
+}
+
+int test_spmv() {
+    // Rows of very different lengths: vertex 0 is the target of every other vertex
+    const std::size_t n = 5000;
+    std::vector<std::pair<std::size_t, std::size_t>> el;
+    std::uint64_t x = 7;
+    auto next = [&] { x = x * 6364136223846793005ull + 1442695040888963407ull; return x >> 33; };
+    for (std::size_t v = 1; v < n; ++v)
+        el.emplace_back(v, 0);
+    for (std::size_t k = 0; k < 4 * n; ++k)
+        el.emplace_back(next() % n, next() % n);
+    std::erase_if(el, [](const auto &p) { return p.first == p.second; });
+    std::sort(el.begin(), el.end());
+    el.erase(std::unique(el.begin(), el.end()), el.end());
+    const graph::AdjacencyList<graph::tags::Directed> g(n, el.begin(), el.end());
+
+    graph::ThreadPool pool(3);
+    const graph::TransposedCSR<> a(g, pool);
+    assert(a.numRows() == n && a.numEntries() == el.size());
+    for (std::size_t v = 0; v < n; ++v)
+        assert(std::is_sorted(a.sources.begin() + a.offsets[v], a.sources.begin() + a.offsets[v + 1]));
+    assert(a.offsets[1] == n - 1);
+
+    std::vector<double> in(n), expected(n, 0), actual;
+    for (std::size_t v = 0; v < n; ++v)
+        in[v] = double(next() % 1000) / 8;
+    for (const auto &[u, v] : el)
+        expected[v] += in[u];
+    graph::spmv(a, in, actual, graph::PlusTimes<double>(), pool);
+    for (std::size_t v = 0; v < n; ++v)
+        assert(std::abs(actual[v] - expected[v]) <= 1e-9 * (1 + expected[v]));
+
+    std::vector<float> inf(in.begin(), in.end()), actualf;
+    graph::spmv(a, inf, actualf);
+    for (std::size_t v = 0; v < n; ++v)
+        assert(std::abs(actualf[v] - expected[v]) <= 1e-4 * (1 + expected[v]));
+
+    // One round of Bellman-Ford relaxation in the (min, +) semiring, with the weights as entries
+    std::vector<std::uint64_t> weight(a.numEntries()), dist(n, graph::MinPlus<std::uint64_t>::zero()), relaxed;
+    for (std::size_t v = 0; v < n; ++v)
+        for (std::size_t k = a.offsets[v]; k < a.offsets[v + 1]; ++k)
+            weight[k] = (a.sources[k] * 31 + v) % 17 + 1;
+    dist[0] = 0;
+    dist[1] = 5;
+    graph::spmv(a, weight, dist, relaxed, graph::MinPlus<std::uint64_t>(), pool);
+    for (std::size_t v = 0; v < n; ++v)
+    {
+        std::uint64_t best = graph::MinPlus<std::uint64_t>::zero();
+        if (edge(0, v, g))
+            best = std::min<std::uint64_t>(best, v % 17 + 1);
+        if (edge(1, v, g))
+            best = std::min<std::uint64_t>(best, 5 + (31 + v) % 17 + 1);
+        assert(relaxed[v] == best);
+    }
+
+    // The gathered sums, and the scalar ones taken for more elements than signed gather offsets reach
+    std::vector<std::uint32_t> idx;
+    for (std::size_t k = 0; k < 101; ++k)
+        idx.push_back(static_cast<std::uint32_t>(next() % n));
+    for (std::size_t count : {0, 3, 8, 13, 101})
+    {
+        double sum = 0;
+        for (std::size_t k = 0; k < count; ++k)
+            sum += in[idx[k]];
+        for (std::size_t size : {n, std::size_t(1) << 31, std::size_t(1) << 32})
+        {
+            assert(std::abs(graph::detail::gatherSum(in.data(), size, idx.data(), count) - sum) <= 1e-9 * (1 + sum));
+            assert(std::abs(graph::detail::gatherSum(inf.data(), size, idx.data(), count) - sum) <= 1e-4 * (1 + sum));
+        }
+    }
+
+    const graph::TransposedCSR<> empty(graph::AdjacencyList<graph::tags::Directed>{});
+    graph::spmv(empty, std::vector<double>{}, actual);
+    assert(empty.numRows() == 0 && actual.empty());
+
+    return 0;
+}
+
+int test_page_rank() {
+    // A random graph with vertices without out-edges, against plain power iteration over the edges
+    const std::size_t n = 2000;
+    const double damping = 0.85;
+    std::vector<std::pair<std::size_t, std::size_t>> el;
+    std::uint64_t x = 11;
+    auto next = [&] { x = x * 6364136223846793005ull + 1442695040888963407ull; return x >> 33; };
+    for (std::size_t k = 0; k < 5 * n; ++k)
+    {
+        const std::size_t u = next() % n, v = next() % (n / 2);
+        if (u % 10 != 0 && u != v)
+            el.emplace_back(u, v);
+    }
+    std::sort(el.begin(), el.end());
+    el.erase(std::unique(el.begin(), el.end()), el.end());
+    const graph::AdjacencyList<graph::tags::Directed> g(n, el.begin(), el.end());
+
+    std::vector<double> expected(n, 1.0 / n);
+    for (int it = 0; it < 200; ++it)
+    {
+        std::vector<double> r(n, 0);
+        double dangling = 0;
+        for (std::size_t u = 0; u < n; ++u)
+            if (outDegree(u, g) == 0)
+                dangling += expected[u];
+        for (const auto &[u, v] : el)
+            r[v] += damping * expected[u] / double(outDegree(u, g));
+        for (auto &v : r)
+            v += (1 - damping + damping * dangling) / n;
+        expected = r;
+    }
+
+    graph::ThreadPool pool(3);
+    const std::vector<double> rank = graph::pageRank(g, damping, 1e-12, 200, pool);
+    double total = 0;
+    for (std::size_t v = 0; v < n; ++v)
+    {
+        assert(std::abs(rank[v] - expected[v]) <= 1e-9);
+        total += rank[v];
+    }
+    assert(std::abs(total - 1) <= 1e-9);
+
+    const std::vector<float> rankf = graph::pageRank<float>(g, 0.85f, 1e-6f);
+    for (std::size_t v = 0; v < n; ++v)
+        assert(std::abs(rankf[v] - expected[v]) <= 1e-5);
+
+    // The same graph as an adjacency matrix gives the same ranks
+    graph::AdjacencyMatrix m(n);
+    for (const auto &[u, v] : el)
+        addEdge(u, v, m);
+    const std::vector<double> rankm = graph::pageRank(m, damping, 1e-12, 200);
+    for (std::size_t v = 0; v < n; ++v)
+        assert(std::abs(rankm[v] - rank[v]) <= 1e-12);
+
+    // Symmetric undirected graphs rank every vertex of a cycle the same
+    std::vector<std::pair<std::size_t, std::size_t>> cycle;
+    for (std::size_t v = 0; v < 10; ++v)
+        cycle.emplace_back(v, (v + 1) % 10);
+    const graph::AdjacencyList<graph::tags::Undirected> ug(10, cycle.begin(), cycle.end());
+    for (double r : graph::pageRank(ug))
+        assert(std::abs(r - 0.1) <= 1e-9);
+
+    assert(graph::pageRank(graph::AdjacencyList<graph::tags::Directed>{}).empty());
+
+    return 0;
+}
+
+// Checks that the generated edges are over [0, n), sorted, and without self-loops and duplicates
+void check_simple_edges(std::size_t n, const std::vector<std::pair<std::size_t, std::size_t>> &el) {
+    for (std::size_t k = 0; k < el.size(); ++k)
+    {
+        assert(el[k].first < n && el[k].second < n && el[k].first != el[k].second);
+        assert(k == 0 || el[k - 1] < el[k]);
+    }
+}
+
+int test_generators() {
+    graph::ThreadPool serial(0), pool(3);
+
+    // R-MAT: the same edges for any number of threads, and a skewed degree distribution
+    const std::size_t scale = 14, m = 200000;
+    const auto rmat = graph::rmatEdges(scale, m, 42, {}, pool);
+    assert(graph::rmatEdges(scale, m, 42, {}, serial) == rmat);
+    assert(graph::rmatEdges(scale, m, 43, {}, pool) != rmat);
+    check_simple_edges(std::size_t(1) << scale, rmat);
+    assert(rmat.size() > m / 2 && rmat.size() < m);
+    std::vector<std::size_t> degree(std::size_t(1) << scale, 0);
+    for (const auto &[u, v] : rmat)
+        ++degree[u];
+    assert(*std::max_element(degree.begin(), degree.end()) > 20 * m / degree.size());
+    graph::RMatParameters unscrambled;
+    unscrambled.scramble = false;
+    const auto plain = graph::rmatEdges(scale, m, 42, unscrambled, pool);
+    check_simple_edges(std::size_t(1) << scale, plain);
+    std::fill(degree.begin(), degree.end(), 0);
+    for (const auto &[u, v] : plain)
+        ++degree[u];
+    assert(std::max_element(degree.begin(), degree.end()) == degree.begin());
+
+    // Erdős–Rényi: few collisions when sparse
+    const std::size_t n = 50000;
+    const auto er = graph::erdosRenyiEdges(n, 4 * n, 7, pool);
+    assert(graph::erdosRenyiEdges(n, 4 * n, 7, serial) == er);
+    check_simple_edges(n, er);
+    assert(er.size() > 4 * n - 100 && er.size() <= 4 * n);
+    assert(graph::erdosRenyiEdges(1, 10, 7).empty());
+
+    // Grids: complete, and road-like with about the kept fraction of the edges
+    const auto grid = graph::gridEdges(300, 200, 1, 1.0, pool);
+    check_simple_edges(300 * 200, grid);
+    assert(grid.size() == 300 * 199 + 299 * 200);
+    assert(std::binary_search(grid.begin(), grid.end(), std::make_pair(std::size_t(199), std::size_t(399))));
+    assert(!std::binary_search(grid.begin(), grid.end(), std::make_pair(std::size_t(199), std::size_t(200))));
+    const auto roads = graph::gridEdges(300, 200, 1, 0.7, pool);
+    assert(graph::gridEdges(300, 200, 1, 0.7, serial) == roads);
+    check_simple_edges(300 * 200, roads);
+    assert(roads.size() > grid.size() * 68 / 100 && roads.size() < grid.size() * 72 / 100);
+    assert(std::includes(grid.begin(), grid.end(), roads.begin(), roads.end()));
+
+    // Random DAGs: acyclic, but the indices are not a topological order
+    const auto dag = graph::randomDagEdges(n, 3 * n, 5, pool);
+    assert(graph::randomDagEdges(n, 3 * n, 5, serial) == dag);
+    check_simple_edges(n, dag);
+    const auto dg = graph::buildGraph<graph::AdjacencyList<graph::tags::Directed>>(n, dag, pool);
+    assert(numEdges(dg) == dag.size());
+    std::vector<std::size_t> order, level;
+    assert(graph::parallelTopoSort(dg, std::back_inserter(order), level, pool));
+    assert(std::any_of(dag.begin(), dag.end(), [](const auto &e) { return e.first > e.second; }));
+
+    // Undirected graphs get each edge once, in bulk or streamed
+    const auto ug = graph::buildGraph<graph::CompressedGraph<graph::tags::Undirected>>(n, er, pool);
+    graph::AdjacencyList<graph::tags::Undirected> streamed;
+    graph::streamEdges(n, er, streamed, pool);
+    assert(numVertices(streamed) == n && numEdges(streamed) == numEdges(ug));
+    assert(numEdges(ug) < er.size() && numEdges(ug) > er.size() - 100);
+    for (const auto &[u, v] : er)
+        assert(edge(u, v, streamed) && edge(v, u, streamed));
+
+    graph::AdjacencyList<graph::tags::Bidirectional> bg(10);
+    graph::streamEdges(300 * 200, roads, bg);
+    assert(numVertices(bg) == 300 * 200 && numEdges(bg) == roads.size());
+
+    // Generators hand their chunks in the same order for any number of threads
+    const graph::RMatGenerator rmatGen{scale, m, 42};
+    static_assert(graph::EdgeGenerator<graph::RMatGenerator> && graph::EdgeGenerator<graph::GridGenerator>);
+    std::vector<graph::detail::GeneratedEdges> chunks, serialChunks;
+    rmatGen.generate([&](const auto &chunk) { chunks.push_back(chunk); }, pool);
+    rmatGen.generate([&](const auto &chunk) { serialChunks.push_back(chunk); }, serial);
+    assert(chunks.size() == (m + 65535) / 65536 && chunks == serialChunks);
+
+    // Straight from the chunks into graphs, each edge once
+    const graph::ErdosRenyiGenerator erGen{n, 4 * n, 7};
+    using Indexed = graph::AdjacencyList<graph::tags::Undirected, graph::NoProp, graph::NoProp, graph::HashEdgeIndex<>>;
+    const auto indexed = graph::buildGraph<Indexed>(erGen, pool);
+    assert(numVertices(indexed) == n && numEdges(indexed) == numEdges(ug));
+    for (const auto &[u, v] : er)
+        assert(edge(u, v, indexed) && edge(v, u, indexed));
+    const auto compressed = graph::buildGraph<graph::CompressedGraph<graph::tags::Directed>>(rmatGen, pool);
+    graph::detail::GeneratedEdges compressedEdges;
+    for (auto e : edges(compressed))
+        compressedEdges.emplace_back(source(e, compressed), target(e, compressed));
+    assert(compressedEdges == rmat);
+    const auto plainDag = graph::buildGraph<graph::AdjacencyList<graph::tags::Directed>>(graph::RandomDagGenerator{n, 3 * n, 5}, pool);
+    assert(numEdges(plainDag) == dag.size());
+    graph::AdjacencyList<graph::tags::Undirected> streamedGen;
+    graph::streamGenerated(erGen, streamedGen, pool);
+    assert(numVertices(streamedGen) == n && numEdges(streamedGen) == numEdges(ug));
+    graph::AdjacencyList<graph::tags::Bidirectional> roadGraph;
+    graph::streamGenerated(graph::GridGenerator{300, 200, 1, 0.7}, roadGraph, pool);
+    assert(numVertices(roadGraph) == 300 * 200 && numEdges(roadGraph) == roads.size());
+
+    return 0;
+}
+
+// Checks that newIndex is a permutation and that h is g permuted by it
+template <typename G>
+void check_permuted(const G &g, const G &h, const std::vector<std::size_t> &newIndex) {
+    std::vector<std::size_t> sorted = newIndex;
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t i = 0; i < sorted.size(); ++i)
+        assert(sorted[i] == i);
+    assert(numVertices(h) == numVertices(g) && numEdges(h) == numEdges(g));
+    for (auto e : edges(g))
+        assert(edge(newIndex[source(e, g)], newIndex[target(e, g)], h));
+}
+
+// The largest difference between the indices of the end-points of an edge
+template <typename G>
+std::size_t bandwidth(const G &g) {
+    std::size_t b = 0;
+    for (auto e : edges(g))
+        b = std::max(b, std::max(source(e, g), target(e, g)) - std::min(source(e, g), target(e, g)));
+    return b;
+}
+
+int test_reorder() {
+    graph::ThreadPool pool(3);
+
+    // A grid with scrambled labels: RCM brings it back to a band
+    const std::size_t rows = 60, cols = 80, n = rows * cols;
+    const auto grid = graph::gridEdges(rows, cols, 1);
+    std::vector<std::size_t> shuffle(n);
+    for (std::size_t i = 0; i < n; ++i)
+        shuffle[i] = i;
+    std::uint64_t x = 3;
+    for (std::size_t k = n; k > 1; --k)
+    {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+        std::swap(shuffle[k - 1], shuffle[(x >> 33) % k]);
+    }
+    using UG = graph::AdjacencyList<graph::tags::Undirected>;
+    const UG ordered(n, grid.begin(), grid.end());
+    const UG g = graph::permute(ordered, shuffle, pool);
+    check_permuted(ordered, g, shuffle);
+    assert(bandwidth(g) > n / 2);
+
+    const auto rcm = graph::reorder(g, graph::tags::RCMOrder(), pool);
+    check_permuted(g, rcm.graph, rcm.newIndex);
+    assert(bandwidth(rcm.graph) <= 2 * std::min(rows, cols));
+    const auto bfs = graph::reorder(g, graph::tags::BFSOrder(), pool);
+    check_permuted(g, bfs.graph, bfs.newIndex);
+    assert(bfs.newIndex[0] == 0 && bandwidth(bfs.graph) <= 2 * (rows + cols));
+
+    // Per-vertex arrays move with the vertices, e.g., BFS distances
+    std::vector<std::size_t> distance, permutedDistance;
+    graph::parallelBfs(g, 0, distance, pool);
+    graph::parallelBfs(rcm.graph, rcm.newIndex[0], permutedDistance, pool);
+    assert(graph::permuteProperties(distance, rcm.newIndex, pool) == permutedDistance);
+    assert(graph::permuteProperties(permutedDistance, graph::inversePermutation(rcm.newIndex)) == distance);
+
+    // Degree and hub orders on a skewed directed graph
+    const std::size_t scale = 12;
+    const auto rmat = graph::rmatEdges(scale, 8 << scale, 4, {}, pool);
+    using DG = graph::AdjacencyList<graph::tags::Bidirectional>;
+    const DG dg(std::size_t(1) << scale, rmat.begin(), rmat.end());
+    auto degree = [](const DG &h, std::size_t v) { return outDegree(v, h) + inDegree(v, h); };
+    const auto byDegree = graph::reorder(dg, graph::tags::DegreeOrder(), pool);
+    check_permuted(dg, byDegree.graph, byDegree.newIndex);
+    for (std::size_t v = 0; v + 1 < numVertices(dg); ++v)
+        assert(degree(byDegree.graph, v) >= degree(byDegree.graph, v + 1));
+    const auto hubs = graph::reorder(dg, graph::tags::HubClusterOrder(), pool);
+    check_permuted(dg, hubs.graph, hubs.newIndex);
+    const double average = 2.0 * numEdges(dg) / numVertices(dg);
+    std::size_t numHubs = 0;
+    while (numHubs < numVertices(dg) && degree(hubs.graph, numHubs) > average)
+        ++numHubs;
+    assert(numHubs > 0 && numHubs < numVertices(dg) / 2);
+    for (std::size_t v = numHubs; v < numVertices(dg); ++v)
+        assert(degree(hubs.graph, v) <= average);
+    for (std::size_t u = 0; u + 1 < numVertices(dg); ++u)
+        if ((degree(dg, u) > average) == (degree(dg, u + 1) > average))
+            assert(hubs.newIndex[u] < hubs.newIndex[u + 1]);
+
+    // Properties are copied over
+    graph::AdjacencyList<graph::tags::Directed, int, double> pg;
+    for (int i = 0; i < 4; ++i)
+        addVertex(10 * i, pg);
+    addEdge(0, 1, 0.5, pg);
+    addEdge(2, 1, 1.5, pg);
+    addEdge(3, 0, 2.5, pg);
+    const std::vector<std::size_t> reverse{3, 2, 1, 0};
+    const auto ph = graph::permute(pg, reverse);
+    assert(ph[0] == 30 && ph[3] == 0 && numEdges(ph) == 3);
+    assert(ph[*edge(3, 2, ph)] == 0.5 && ph[*edge(1, 2, ph)] == 1.5 && ph[*edge(0, 3, ph)] == 2.5);
+
+    const UG empty;
+    assert(graph::reorder(empty, graph::tags::RCMOrder()).newIndex.empty());
+
+    return 0;
+}
+
+// A memory resource counting the allocations it forwards to the default one
+struct CountingResource : std::pmr::memory_resource {
+    std::size_t allocations = 0, deallocations = 0;
+
+    void *do_allocate(std::size_t bytes, std::size_t align) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t align) override
+    {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+};
+
+struct Entry {
+    std::uint32_t first, second;
+};
+
+int test_arena_edge_lists() {
+    // Small vectors allocate only past their inline capacity
+    CountingResource counting;
+    graph::SmallVector<Entry, 3> sv;
+    for (std::uint32_t i = 0; i < 3; ++i)
+        sv.emplace_back(counting, i, 2 * i);
+    assert(counting.allocations == 0 && sv.size() == 3 && sv.capacity() == 3);
+    sv.emplace_back(counting, 3u, 6u);
+    assert(counting.allocations == 1 && sv.capacity() == 6);
+    for (std::uint32_t i = 4; i < 7; ++i)
+        sv.emplace_back(counting, i, 2 * i);
+    assert(counting.allocations == 2 && counting.deallocations == 1 && sv.size() == 7);
+    for (std::uint32_t i = 0; i < 7; ++i)
+        assert(sv[i].first == i && sv[i].second == 2 * i);
+    auto moved = std::move(sv);
+    assert(sv.empty() && moved.size() == 7 && moved[6].second == 12);
+    graph::SmallVector<Entry, 3> small, copy;
+    small.emplace_back(counting, 1u, 2u);
+    copy.assign(small, counting);
+    auto movedSmall = std::move(small);
+    assert(copy.size() == 1 && movedSmall.size() == 1 && movedSmall[0].second == 2 && counting.allocations == 2);
+    counting.deallocate(moved.data(), moved.capacity() * sizeof(moved[0]), alignof(decltype(moved[0])));
+
+    // Arena graphs model the same concepts and hold the same edges as vector-backed ones
+    using Arena = graph::ArenaAdjacencyList<graph::tags::Bidirectional>;
+    using Vector = graph::AdjacencyList<graph::tags::Bidirectional>;
+    static_assert(graph::BidirectionalGraph<Arena> && graph::MutableGraph<Arena> && graph::EdgeListGraph<Arena>);
+    const std::size_t n = 20000;
+    const auto el = graph::rmatEdges(14, 6 * n, 1);
+    const Vector expected(std::size_t(1) << 14, el.begin(), el.end());
+    const Arena bulk(std::size_t(1) << 14, el.begin(), el.end());
+    assert_same_adjacency(expected, bulk);
+    Arena sequential;
+    for (std::size_t i = 0; i < (std::size_t(1) << 14); ++i)
+        addVertex(sequential);
+    for (const auto &[u, v] : el)
+        addEdge(u, v, sequential);
+    assert_same_adjacency(expected, sequential);
+
+    // Copies have their own arena, so they outlive the original
+    auto original = std::make_unique<Arena>(bulk);
+    Arena copied(*original);
+    Arena assigned;
+    assigned = *original;
+    Arena movedGraph(std::move(*original));
+    original.reset();
+    assert_same_adjacency(expected, copied);
+    assert_same_adjacency(expected, assigned);
+    assert_same_adjacency(expected, movedGraph);
+    addEdge(0, 1, copied);
+    assert(numEdges(copied) == numEdges(expected) + 1 && numEdges(assigned) == numEdges(expected));
+
+    // With properties, and algorithms run on them unchanged
+    graph::ArenaAdjacencyList<graph::tags::Directed, int, double> pg(3);
+    addEdge(0, 1, 1.5, pg);
+    addEdge(1, 2, 2.5, pg);
+    pg[std::size_t(2)] = 7;
+    const auto pc = pg;
+    assert(pc[*edge(1, 2, pc)] == 2.5 && pc[std::size_t(2)] == 7);
+    std::vector<std::size_t> sorted;
+    graph::topoSort(pc, std::back_inserter(sorted));
+    assert((sorted == std::vector<std::size_t>{2, 1, 0}));
+
+    return 0;
+}
+
+// The events of the visitors above for the edges of a traversal range
+template <typename G, typename R>
+std::vector<std::string> dfs_edge_log(const G &g, R &&range) {
+    std::vector<std::string> log;
+    const char *names[] = {"tree", "back", "forwardOrCross"};
+    for (const auto &[e, kind] : range)
+        log.push_back(std::string(names[int(kind)]) + " " + std::to_string(source(e, g)) + " " +
+                      std::to_string(target(e, g)));
+    return log;
+}
+
+std::vector<std::string> filter_log(const std::vector<std::string> &log, std::initializer_list<std::string> events) {
+    std::vector<std::string> result;
+    for (const auto &entry : log)
+        for (const auto &event : events)
+            if (entry.compare(0, event.size() + 1, event + " ") == 0)
+                result.push_back(entry);
+    return result;
+}
+
+int test_traversal_ranges() {
+    using G = graph::AdjacencyList<graph::tags::Directed>;
+    using Range = decltype(graph::dfsRange(std::declval<const G &>(), 0));
+    static_assert(std::ranges::input_range<Range> && std::ranges::view<Range>);
+    static_assert(std::ranges::input_range<decltype(graph::bfsEdgeRange(std::declval<const G &>(), 0))>);
+
+    // A random graph in which a path makes every vertex reachable from 0
+    const std::size_t n = 2000;
+    auto el = graph::erdosRenyiEdges(n, 8 * n, 3);
+    for (std::size_t v = 0; v + 1 < n; ++v)
+        el.emplace_back(v, v + 1);
+    std::sort(el.begin(), el.end());
+    el.erase(std::unique(el.begin(), el.end()), el.end());
+    el.erase(std::remove_if(el.begin(), el.end(), [](auto e) { return e.first == e.second; }), el.end());
+    const G g(n, el.begin(), el.end());
+
+    // The same vertices and edge classes, in the same order, as the visitors get
+    std::vector<std::string> dfsLog;
+    graph::dfs(g, RecordingVisitor(&dfsLog), graph::tags::DFSIterative());
+    std::vector<std::string> discovered;
+    for (auto v : graph::dfsRange(g, 0))
+        discovered.push_back("discover " + std::to_string(v) + " " + std::to_string(std::size_t(-1)));
+    assert(discovered.size() == n && discovered == filter_log(dfsLog, {"discover"}));
+    assert(dfs_edge_log(g, graph::dfsEdgeRange(g, 0)) == filter_log(dfsLog, {"tree", "back", "forwardOrCross"}));
+
+    std::vector<std::string> bfsLog;
+    graph::bfs(g, 0, BFSRecordingVisitor{{}, &bfsLog});
+    std::vector<std::string> bfsDiscovered, bfsEdges;
+    for (auto v : graph::bfsRange(g, 0))
+        bfsDiscovered.push_back("discover " + std::to_string(v));
+    const char *names[] = {"tree", "grey", "black"};
+    for (const auto &[e, kind] : graph::bfsEdgeRange(g, 0))
+        bfsEdges.push_back(std::string(names[int(kind)]) + " " + std::to_string(target(e, g)));
+    assert(bfsDiscovered == filter_log(bfsLog, {"discover"}));
+    assert(bfsEdges == filter_log(bfsLog, {"tree", "grey", "black"}));
+
+    // Stopping early, through the standard algorithms and views
+    auto search = graph::bfsRange(g, 0);
+    auto found = std::ranges::find(search, bfsLog.size() % n);
+    assert(found != search.end() && *found == bfsLog.size() % n);
+    std::vector<std::size_t> firstEven;
+    for (auto v : graph::dfsRange(g, 0) | std::views::filter([](auto v) { return v % 2 == 0; }) | std::views::take(5))
+        firstEven.push_back(v);
+    std::vector<std::size_t> expected;
+    for (const auto &entry : filter_log(dfsLog, {"discover"}))
+    {
+        const std::size_t v = std::stoul(entry.substr(9));
+        if (v % 2 == 0 && expected.size() < 5)
+            expected.push_back(v);
+    }
+    assert(firstEven == expected);
+    std::size_t treeEdges = 0;
+    for (const auto &[e, kind] : graph::dfsEdgeRange(g, 0))
+    {
+        treeEdges += kind == graph::DFSEdgeKind::Tree;
+        if (target(e, g) == n - 1)
+            break;
+    }
+    assert(treeEdges > 0 && treeEdges < n);
+
+    // Only the vertices reachable from the start, and undirected tree edges form a spanning tree
+    graph::AdjacencyList<graph::tags::Undirected> u(6);
+    addEdge(0, 1, u);
+    addEdge(1, 2, u);
+    addEdge(2, 0, u);
+    addEdge(3, 4, u);
+    std::vector<std::size_t> component;
+    std::ranges::copy(graph::bfsRange(u, 1), std::back_inserter(component));
+    std::ranges::sort(component);
+    assert((component == std::vector<std::size_t>{0, 1, 2}));
+    std::size_t backEdges = 0, spanning = 0;
+    for (const auto &[e, kind] : graph::dfsEdgeRange(u, 3))
+    {
+        spanning += kind == graph::DFSEdgeKind::Tree;
+        backEdges += kind == graph::DFSEdgeKind::Back;
+    }
+    assert(spanning == 1 && backEdges == 1);
+    assert(std::ranges::distance(graph::dfsRange(u, 5)) == 1);
+
+    return 0;
+}
+
+// The sorted targets of the out-edges, or sources of the in-edges, of each vertex
+template <typename G, typename Edges>
+std::vector<std::vector<std::size_t>> sorted_rows(const G &g, Edges edgesOf, bool in = false) {
+    std::vector<std::vector<std::size_t>> rows(numVertices(g));
+    for (auto v : vertices(g))
+    {
+        for (auto e : edgesOf(v, g))
+            rows[getIndex(v, g)].push_back(getIndex(in ? source(e, g) : target(e, g), g));
+        std::sort(rows[getIndex(v, g)].begin(), rows[getIndex(v, g)].end());
+    }
+    return rows;
+}
+
+template <typename Category, typename Encoding>
+void check_varint_graph(std::size_t n, const graph::detail::GeneratedEdges &el) {
+    using V = graph::VarintGraph<Category, Encoding>;
+    static_assert(graph::VertexListGraph<V> && graph::EdgeListGraph<V> && graph::IncidenceGraph<V> &&
+                  graph::IndexedGraph<V>);
+    static_assert(graph::BidirectionalGraph<V> == std::is_same_v<Category, graph::tags::Bidirectional>);
+    const graph::AdjacencyList<Category> expected(n, el.begin(), el.end());
+    const V g(n, el.begin(), el.end());
+    assert(numVertices(g) == n && numEdges(g) == numEdges(expected));
+    auto out = [](auto v, const auto &h) { return outEdges(v, h); };
+    assert(sorted_rows(g, out) == sorted_rows(expected, out));
+    for (auto v : vertices(g))
+    {
+        assert(outDegree(v, g) == outDegree(v, expected));
+        // decoded in increasing order
+        auto row = outEdges(v, g);
+        assert(std::is_sorted(row.begin(), row.end(), [&](auto a, auto b) { return target(a, g) < target(b, g); }));
+    }
+    if constexpr (graph::BidirectionalGraph<V>)
+    {
+        auto in = [](auto v, const auto &h) { return inEdges(v, h); };
+        assert(sorted_rows(g, in, true) == sorted_rows(expected, in, true));
+        for (auto v : vertices(g))
+            assert(inDegree(v, g) == inDegree(v, expected));
+    }
+    // each undirected edge once, from its smaller end-point
+    std::vector<std::pair<std::size_t, std::size_t>> listed, reference;
+    for (auto e : edges(g))
+        listed.emplace_back(source(e, g), target(e, g));
+    for (auto e : edges(expected))
+        if constexpr (std::is_same_v<Category, graph::tags::Undirected>)
+            reference.emplace_back(std::min(source(e, expected), target(e, expected)),
+                                   std::max(source(e, expected), target(e, expected)));
+        else
+            reference.emplace_back(source(e, expected), target(e, expected));
+    std::sort(listed.begin(), listed.end());
+    std::sort(reference.begin(), reference.end());
+    assert(listed == reference);
+
+    // Algorithms run on the compressed graph unchanged
+    std::vector<std::size_t> distance, expectedDistance;
+    graph::parallelBfs(g, 0, distance);
+    graph::parallelBfs(expected, 0, expectedDistance);
+    assert(distance == expectedDistance);
+    assert(std::ranges::distance(graph::dfsRange(g, 0)) == std::ranges::distance(graph::dfsRange(expected, 0)));
+
+    // Copies of other graphs, and much smaller than their CSR
+    const V copy(expected);
+    assert(sorted_rows(copy, out) == sorted_rows(expected, out));
+    const V fromCompressed{graph::CompressedGraph<Category>(expected)};
+    assert(sorted_rows(fromCompressed, out) == sorted_rows(expected, out));
+    // unsorted edge lists, and graphs without the rows of V, are sorted into rows first
+    const auto reversed = std::vector(el.rbegin(), el.rend());
+    const V unsorted(n, reversed.begin(), reversed.end());
+    const V fromDirected{graph::AdjacencyList<graph::tags::Directed>(n, el.begin(), el.end())};
+    for (const V *h : {&unsorted, &fromDirected})
+    {
+        assert(numEdges(*h) == numEdges(g) && sorted_rows(*h, out) == sorted_rows(g, out));
+        if constexpr (graph::BidirectionalGraph<V>)
+        {
+            auto in = [](auto v, const auto &h) { return inEdges(v, h); };
+            assert(sorted_rows(*h, in, true) == sorted_rows(g, in, true));
+        }
+    }
+    const std::size_t rows = std::is_same_v<Category, graph::tags::Directed> ? 1 : 2;
+    assert(g.memoryBytes() < rows * (numEdges(g) + n) * sizeof(std::size_t) / 2);
+}
+
+int test_varint_graph() {
+    // The encodings themselves, at the lengths where they change
+    std::vector<std::uint8_t> bytes;
+    const std::vector<std::uint64_t> values = {0, 1, 127, 128, 16383, 16384, (1ull << 32) - 1, 1ull << 40, ~0ull};
+    for (auto x : values)
+        graph::detail::putVarint(bytes, x);
+    const std::uint8_t *p = bytes.data();
+    for (auto x : values)
+        assert(graph::detail::getVarint(p) == x);
+    assert(p == bytes.data() + bytes.size());
+    for (std::int64_t x : {0ll, 1ll, -1ll, 1000000ll, -1000000ll})
+        assert(graph::detail::unzigzag(graph::detail::zigzag(x)) == x);
+    bytes.clear();
+    const std::uint32_t group[] = {0, 255, 256, 65536, 16777216, ~0u, 7};
+    graph::detail::putGroupVarint(bytes, group, 4);
+    graph::detail::putGroupVarint(bytes, group + 4, 3);
+    assert(bytes.size() == 2 + (1 + 1 + 2 + 3) + (4 + 4 + 1));
+    bytes.insert(bytes.end(), graph::detail::varintPadding, 0);
+    graph::detail::VarintDecoder<graph::tags::GroupVarint> decoder{bytes.data()};
+    for (auto x : group)
+        assert(decoder.next() == x);
+
+    // Graphs, with a gap of more than two bytes and the vertices before their neighbours
+    const std::size_t n = 1 << 12;
+    auto el = graph::rmatEdges(12, 8 * n, 5);
+    el.emplace_back(n - 1, 0);
+    el.emplace_back(0, n - 1);
+    el.emplace_back(1, n - 1);
+    std::sort(el.begin(), el.end());
+    el.erase(std::unique(el.begin(), el.end()), el.end());
+    auto undirected = el;
+    for (auto &[u, v] : undirected)
+        if (u > v)
+            std::swap(u, v);
+    std::sort(undirected.begin(), undirected.end());
+    undirected.erase(std::unique(undirected.begin(), undirected.end()), undirected.end());
+    check_varint_graph<graph::tags::Directed, graph::tags::Varint>(n, el);
+    check_varint_graph<graph::tags::Directed, graph::tags::GroupVarint>(n, el);
+    check_varint_graph<graph::tags::Bidirectional, graph::tags::Varint>(n, el);
+    check_varint_graph<graph::tags::Bidirectional, graph::tags::GroupVarint>(n, el);
+    check_varint_graph<graph::tags::Undirected, graph::tags::Varint>(n, undirected);
+    check_varint_graph<graph::tags::Undirected, graph::tags::GroupVarint>(n, undirected);
+
+    // Parallel edges are merged, and empty graphs and rows are fine
+    const std::vector<std::pair<int, int>> parallel = {{0, 2}, {0, 2}, {2, 0}, {1, 1}};
+    const graph::VarintGraph<graph::tags::Directed> d(4, parallel.begin(), parallel.end());
+    assert(numEdges(d) == 3 && outDegree(0, d) == 1 && outDegree(3, d) == 0);
+    assert(outEdges(3, d).begin() == outEdges(3, d).end());
+    assert(target(*outEdges(1, d).begin(), d) == 1);
+    const graph::VarintGraph<graph::tags::Undirected, graph::tags::GroupVarint> empty;
+    assert(numVertices(empty) == 0 && numEdges(empty) == 0 && edges(empty).begin() == edges(empty).end());
+
+    return 0;
+}
+
+template <typename Category>
+void check_concurrent_graph(std::size_t n, const graph::detail::GeneratedEdges &el) {
+    using C = graph::ConcurrentGraph<Category>;
+    static_assert(graph::VertexListGraph<C> && graph::EdgeListGraph<C> && graph::IncidenceGraph<C> &&
+                  graph::MutableGraph<C> && graph::IndexedGraph<C>);
+    static_assert(graph::BidirectionalGraph<C> == std::is_same_v<Category, graph::tags::Bidirectional>);
+    const graph::AdjacencyList<Category> expected(n, el.begin(), el.end());
+    auto out = [](auto v, const auto &h) { return outEdges(v, h); };
+    auto in = [](auto v, const auto &h) { return inEdges(v, h); };
+
+    // Half of the vertices exist up front, the others are added while the edges are
+    C g(n / 2);
+    std::atomic<std::size_t> added{0};
+    std::vector<std::thread> threads;
+    const std::size_t numThreads = 4;
+    for (std::size_t t = 0; t < numThreads; ++t)
+        threads.emplace_back([&, t] {
+            if (t == 0)
+                for (std::size_t v = n / 2; v < n; ++v)
+                {
+                    addVertex(g);
+                    added.store(v + 1, std::memory_order_release);
+                }
+            for (std::size_t k = t; k < el.size(); k += numThreads)
+            {
+                const auto [u, v] = el[k];
+                while (std::max(u, v) >= std::max(n / 2, added.load(std::memory_order_acquire)))
+                    std::this_thread::yield();
+                addEdge(u, v, g);
+            }
+        });
+    for (auto &thread : threads)
+        thread.join();
+
+    assert(numVertices(g) == n && numEdges(g) == el.size() && numEdges(g) == numEdges(expected));
+    assert(sorted_rows(g, out) == sorted_rows(expected, out));
+    for (auto v : vertices(g))
+        assert(outDegree(v, g) == outDegree(v, expected));
+    // every id once, from each end-point of an undirected edge
+    std::vector<std::size_t> ids;
+    for (auto e : edges(g))
+        ids.push_back(e.idx);
+    std::sort(ids.begin(), ids.end());
+    for (std::size_t i = 0; i < ids.size(); ++i)
+        assert(ids[i] == i);
+
+    const auto frozen = g.freeze();
+    assert(numVertices(frozen) == n && numEdges(frozen) == el.size());
+    assert(sorted_rows(frozen, out) == sorted_rows(expected, out));
+    if constexpr (graph::BidirectionalGraph<C>)
+    {
+        assert(sorted_rows(g, in, true) == sorted_rows(expected, in, true));
+        assert(sorted_rows(frozen, in, true) == sorted_rows(expected, in, true));
+        // the in-edges refer to their out-edges
+        for (auto v : vertices(frozen))
+            for (auto e : inEdges(v, frozen))
+            {
+                auto row = outEdges(source(e, frozen), frozen);
+                assert(std::count(row.begin(), row.end(), e) == 1);
+            }
+    }
+    if constexpr (std::is_same_v<Category, graph::tags::Undirected>)
+        for (auto v : vertices(frozen))
+            for (auto e : outEdges(v, frozen))
+            {
+                auto row = outEdges(target(e, frozen), frozen);
+                assert(std::count(row.begin(), row.end(), e) == 1);
+            }
+    std::vector<std::size_t> distance, expectedDistance;
+    graph::parallelBfs(frozen, 0, distance);
+    graph::parallelBfs(expected, 0, expectedDistance);
+    assert(distance == expectedDistance);
+}
+
+int test_concurrent_graph() {
+    const std::size_t n = 3000;
+    auto el = graph::rmatEdges(12, 6 * n, 7);
+    el.erase(std::remove_if(el.begin(), el.end(), [&](auto e) { return e.first >= n || e.second >= n; }), el.end());
+    auto undirected = el;
+    for (auto &[u, v] : undirected)
+        if (u > v)
+            std::swap(u, v);
+    std::sort(undirected.begin(), undirected.end());
+    undirected.erase(std::unique(undirected.begin(), undirected.end()), undirected.end());
+    check_concurrent_graph<graph::tags::Directed>(n, el);
+    check_concurrent_graph<graph::tags::Bidirectional>(n, el);
+    check_concurrent_graph<graph::tags::Undirected>(n, undirected);
+
+    // Frozen from one thread, rows keep the insertion order, past the first block
+    graph::ConcurrentGraph<> g(3);
+    for (std::size_t v : {2, 1, 0, 2, 1, 2, 0, 1})
+        addEdge(0, v, g);
+    const auto frozen = g.freeze();
+    std::vector<std::size_t> targets;
+    for (auto e : outEdges(0, frozen))
+        targets.push_back(e.tar);
+    assert((targets == std::vector<std::size_t>{2, 1, 0, 2, 1, 2, 0, 1}));
+    assert(outDegree(0, g) == 8 && outDegree(1, g) == 0);
+    const graph::ConcurrentGraph<graph::tags::Bidirectional> empty;
+    assert(numVertices(empty.freeze()) == 0 && edges(empty).begin() == edges(empty).end());
+
+    return 0;
+}
+
+// Checks that the order of d is a permutation in which every edge goes forward
+template <typename D>
+void assert_topological(const D &d) {
+    const auto &g = d.graph();
+    assert(d.order().size() == numVertices(g));
+    for (std::size_t k = 0; k < d.order().size(); ++k)
+        assert(d.position(d.order()[k]) == k);
+    for (auto e : edges(g))
+        assert(d.position(source(e, g)) < d.position(target(e, g)));
+}
+
+int test_dynamic_dag() {
+    // Random insertions, accepted exactly when the target does not reach the source
+    const std::size_t n = 300;
+    graph::DynamicDAG<> d(n);
+    graph::detail::Random random(11, 0);
+    std::size_t accepted = 0, rejected = 0;
+    for (std::size_t k = 0; k < 3000; ++k)
+    {
+        const std::size_t u = random.next() % n, v = random.next() % n;
+        if (const auto existing = edge(u, v, d.graph()))
+        {
+            // repeated edges are returned, not added again
+            const auto before = d.order();
+            const std::size_t m = numEdges(d.graph());
+            assert(addEdge(u, v, d) == existing && numEdges(d.graph()) == m && d.order() == before);
+            continue;
+        }
+        bool reaches = u == v;
+        for (auto w : graph::dfsRange(d.graph(), v))
+            reaches = reaches || w == u;
+        const std::size_t m = numEdges(d.graph());
+        const auto e = addEdge(u, v, d);
+        assert(e.has_value() == !reaches);
+        if (e)
+        {
+            ++accepted;
+            assert(source(*e, d.graph()) == u && target(*e, d.graph()) == v && numEdges(d.graph()) == m + 1);
+        }
+        else
+        {
+            ++rejected;
+            assert(numEdges(d.graph()) == m);
+        }
+        if (k % 250 == 0)
+            assert_topological(d);
+    }
+    assert(accepted > 300 && rejected > 300);
+    assert_topological(d);
+
+    // Edges that agree with the order leave it as it is
+    const auto before = d.order();
+    for (std::size_t k = 0; k + 7 < n; k += 7)
+        if (!edge(d.order()[k], d.order()[k + 7], d.graph()))
+            assert(addEdge(d.order()[k], d.order()[k + 7], d));
+    assert(d.order() == before);
+
+    // A chain added backwards is reversed, new vertices come last
+    graph::DynamicDAG<int, double> chain(5);
+    for (std::size_t v = 4; v > 0; --v)
+        assert(addEdge(v, v - 1, 1.0 * v, chain));
+    assert((chain.order() == std::vector<std::size_t>{4, 3, 2, 1, 0}));
+    assert(!addEdge(0, 4, 1.0, chain) && !addEdge(2, 2, 1.0, chain));
+    const auto w = addVertex(7, chain);
+    assert(chain[w] == 7 && chain.position(w) == 5);
+    const auto e = addEdge(w, 4, 2.5, chain);
+    assert(e && chain[*e] == 2.5 && chain.position(w) < chain.position(4));
+    const auto again = addEdge(w, 4, 3.5, chain);
+    assert(again == e && chain[*again] == 2.5 && numEdges(chain.graph()) == 5);
+    assert_topological(chain);
+
+    // Taking over an existing graph, which must be acyclic
+    graph::DynamicDAG<>::Graph g(4);
+    addEdge(3, 2, g);
+    addEdge(2, 1, g);
+    addEdge(1, 0, g);
+    graph::DynamicDAG<> existing(g);
+    assert_topological(existing);
+    assert(!addEdge(0, 3, existing) && addEdge(3, 0, existing));
+    addEdge(0, 3, g);
+    bool thrown = false;
+    try
+    {
+        graph::DynamicDAG<> cyclic(g);
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+
+    return 0;
+}
+
+// Compares the index with a DFS from every vertex of g
+template <typename Graph>
+void check_reachability(const Graph &g, const graph::ReachabilityIndex &index)
+{
+    const std::size_t n = numVertices(g);
+    std::vector<char> reached(n);
+    for (auto u : vertices(g))
+    {
+        std::fill(reached.begin(), reached.end(), 0);
+        for (auto w : graph::dfsRange(g, u))
+            reached[getIndex(w, g)] = 1;
+        for (auto v : vertices(g))
+            assert(index.reachable(getIndex(u, g), getIndex(v, g)) == bool(reached[getIndex(v, g)]));
+    }
+}
+
+int test_reachability() {
+    // A sparse random graph, with strongly connected components and edges between them
+    const std::size_t n = 600;
+    const auto el = graph::erdosRenyiEdges(n, 900, 5);
+    const graph::AdjacencyList<graph::tags::Directed> g(n, el.begin(), el.end());
+    std::vector<std::size_t> component;
+    const std::size_t k = graph::stronglyConnectedComponents(g, component);
+    assert(k > 1 && k < n);
+
+    const graph::ReachabilityIndex closure(g);
+    assert(closure.isClosure() && closure.numComponents() == k);
+    check_reachability(g, closure);
+
+    // Labels, however many, give the same answers, as does a parallel build
+    for (std::size_t labels : {1, 2, 5})
+    {
+        const graph::ReachabilityIndex index(g, 0, labels);
+        assert(!index.isClosure() && index.numComponents() == k);
+        check_reachability(g, index);
+    }
+    graph::ThreadPool pool(3);
+    check_reachability(g, graph::ReachabilityIndex(g, std::size_t(1) << 27, 3, pool));
+    check_reachability(g, graph::ReachabilityIndex(g, 0, 4, pool));
+
+    // A DAG with more components than a word holds, and a CompressedGraph
+    const std::size_t m = 1000;
+    const auto dag = graph::randomDagEdges(m, 3000, 8);
+    const graph::CompressedGraph<graph::tags::Directed> c(m, dag.begin(), dag.end());
+    const graph::ReachabilityIndex dagClosure(c, std::size_t(1) << 27, 3, pool);
+    assert(dagClosure.isClosure() && dagClosure.numComponents() == m);
+    assert(dagClosure.memoryBytes() < m * m / 8 + 64 * m);
+    check_reachability(c, dagClosure);
+    const graph::ReachabilityIndex dagLabels(c, 0, 3, pool);
+    assert(!dagLabels.isClosure());
+    check_reachability(c, dagLabels);
+
+    // The empty graph, and a single cycle
+    const graph::AdjacencyList<graph::tags::Directed> empty;
+    assert(graph::ReachabilityIndex(empty).numComponents() == 0);
+    graph::AdjacencyList<graph::tags::Directed> cycle(4);
+    for (std::size_t v = 0; v < 4; ++v)
+        addEdge(v, (v + 1) % 4, cycle);
+    const graph::ReachabilityIndex cycleIndex(cycle, 0);
+    assert(cycleIndex.numComponents() == 1);
+    check_reachability(cycle, cycleIndex);
+    return 0;
+}
+
+
 int main() {
     test_directed_graph_creation();
     test_bidirectional_graph_creation();
@@ -103,6 +2218,35 @@ int main() {
     test_getIndex();
     test_default_constructor();
     test_copyable();
+    test_compressed_graph_concepts();
+    test_compressed_graph_from_adjacency_list();
+    test_compressed_graph_from_edge_list();
+    test_dfs_iterative_same_events();
+    test_topo_sort_long_chain();
+    test_degrees();
+    test_edge_lookup();
+    test_load_dimacs_buffer();
+    test_load_dimacs_file();
+    test_binary_snapshot();
+    test_adjacency_matrix_bits();
+    test_bulk_insertion();
+    test_compact_indices();
+    test_parallel_topo_sort();
+    test_bfs();
+    test_thread_pool();
+    test_shortest_paths();
+    test_connected_components();
+    test_strongly_connected_components();
+    test_spmv();
+    test_page_rank();
+    test_generators();
+    test_reorder();
+    test_arena_edge_lists();
+    test_traversal_ranges();
+    test_varint_graph();
+    test_concurrent_graph();
+    test_dynamic_dag();
+    test_reachability();
 
     return 0;
 }
\ No newline at end of file